@@ -5,6 +5,7 @@
 #include "utils/assert.h"
 
 #include <cstdint>
+#include <span>
 
 
 namespace core
@@ -82,6 +83,11 @@ public:
      * \param components is the new component array to be copy instead of the old components array
      */
     void CopyAllComponents(const std::vector<T>& components);
+    /**
+     * \brief CopyAllComponents is a method that changes the internal components array by copying a view on components, for example read from a serialized world.
+     * \param components is the new component array to be copy instead of the old components array
+     */
+    void CopyAllComponents(std::span<const T> components);
 protected:
     EntityManager& entityManager_;
     std::vector<T> components_;
@@ -152,4 +158,10 @@ void ComponentManager<T, C>::CopyAllComponents(const std::vector<T>& components)
 {
     components_ = components;
 }
+
+template <typename T, Component C>
+void ComponentManager<T, C>::CopyAllComponents(std::span<const T> components)
+{
+    components_.assign(components.begin(), components.end());
+}
 } // namespace core
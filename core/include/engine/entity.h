@@ -6,6 +6,7 @@
 #include <cstdint>
 #include <vector>
 #include <limits>
+#include <span>
 
 
 namespace core
@@ -81,7 +82,16 @@ public:
      * \return the total size of the EntityMask array.
      */
     [[nodiscard]] std::size_t GetEntitiesSize() const;
-
+    /**
+     * \brief GetAllEntityMasks is a method that returns the internal array of EntityMask.
+     * \return the internal array of EntityMask
+     */
+    [[nodiscard]] const std::vector<EntityMask>& GetAllEntityMasks() const;
+    /**
+     * \brief CopyAllEntityMasks is a method that replaces the internal EntityMask array, used when restoring a serialized world.
+     * \param entityMasks is the new EntityMask array
+     */
+    void CopyAllEntityMasks(std::span<const EntityMask> entityMasks);
 
 private:
     std::vector<EntityMask> entityMasks_;
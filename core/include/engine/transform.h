@@ -39,6 +39,7 @@ public:
 
 /**
  * \brief TransformManager is a class combining a PositionManager, a ScaleManager and a RotationManager in one.
+ * It keeps track of the entities whose transform changed, so that copies of the transforms only write the changed ones.
  */
 class TransformManager
 {
@@ -59,11 +60,28 @@ public:
 
     void AddComponent(Entity entity);
     void RemoveComponent(Entity entity);
+    /**
+     * \brief CopyAllComponents is a method that replaces the positions, scales and rotations arrays.
+     */
+    void CopyAllComponents(std::span<const Vec2f> positions, std::span<const Vec2f> scales, std::span<const Degree> rotations);
+    /**
+     * \brief GetDirtyEntities is a method that gives the entities whose transform was added or changed since the last ClearDirtyEntities.
+     * Setting the same value again does not make an entity dirty.
+     */
+    [[nodiscard]] std::span<const Entity> GetDirtyEntities() const { return dirtyEntities_; }
+    void ClearDirtyEntities();
     
 private:
+    void SetDirty(Entity entity);
+
     PositionManager positionManager_;
     ScaleManager scaleManager_;
     RotationManager rotationManager_;
+    std::vector<Entity> dirtyEntities_;
+    /**
+     * \brief dirtyFlags_ is indexed by entity, so that an entity is only once in dirtyEntities_
+     */
+    std::vector<bool> dirtyFlags_;
 };
 
 }
@@ -0,0 +1,214 @@
+/**
+ * \file fixed.h
+ */
+#pragma once
+
+#include <bit>
+#include <compare>
+#include <cstdint>
+#include <limits>
+
+#include "maths/vec2.h"
+
+namespace core
+{
+/**
+ * \brief Fixed is a signed 16.16 fixed-point number.
+ * All its operations are done on integers, so they give the same bits on every compiler, platform and optimization level.
+ * Its range is [-32768, 32768) with a precision of 1/65536.
+ */
+class Fixed
+{
+public:
+    using RawType = std::int32_t;
+    static constexpr int FRACTIONAL_BITS = 16;
+    static constexpr RawType ONE = RawType{ 1 } << FRACTIONAL_BITS;
+
+    constexpr Fixed() = default;
+    /**
+     * \brief Conversion constructors from float, double and int, so that the game constants can be used directly.
+     * Floating point values are rounded to the nearest fixed-point value.
+     */
+    constexpr Fixed(float value) : value_(static_cast<RawType>(value * static_cast<float>(ONE) + (value < 0.0f ? -0.5f : 0.5f))) {}
+    constexpr Fixed(double value) : value_(static_cast<RawType>(value * ONE + (value < 0.0 ? -0.5 : 0.5))) {}
+    constexpr Fixed(int value) : value_(static_cast<RawType>(static_cast<std::uint32_t>(value) << FRACTIONAL_BITS)) {}
+
+    static constexpr Fixed FromRaw(RawType raw)
+    {
+        Fixed result;
+        result.value_ = raw;
+        return result;
+    }
+    [[nodiscard]] constexpr RawType GetRaw() const { return value_; }
+    [[nodiscard]] constexpr float ToFloat() const { return static_cast<float>(value_) / static_cast<float>(ONE); }
+    constexpr explicit operator float() const { return ToFloat(); }
+
+    //Additions wrap around instead of overflowing, like the unsigned integers
+    friend constexpr Fixed operator+(Fixed a, Fixed b)
+    {
+        return FromRaw(static_cast<RawType>(static_cast<std::uint32_t>(a.value_) + static_cast<std::uint32_t>(b.value_)));
+    }
+    friend constexpr Fixed operator-(Fixed a, Fixed b)
+    {
+        return FromRaw(static_cast<RawType>(static_cast<std::uint32_t>(a.value_) - static_cast<std::uint32_t>(b.value_)));
+    }
+    friend constexpr Fixed operator*(Fixed a, Fixed b)
+    {
+        return FromRaw(static_cast<RawType>((static_cast<std::int64_t>(a.value_) * b.value_) >> FRACTIONAL_BITS));
+    }
+    /**
+     * \brief Division saturates when the result does not fit, including the division by zero.
+     */
+    friend constexpr Fixed operator/(Fixed a, Fixed b)
+    {
+        if (b.value_ == 0)
+        {
+            return FromRaw(a.value_ < 0 ? std::numeric_limits<RawType>::min() : std::numeric_limits<RawType>::max());
+        }
+        const auto result = (static_cast<std::int64_t>(a.value_) * ONE) / b.value_;
+        if (result > std::numeric_limits<RawType>::max())
+        {
+            return FromRaw(std::numeric_limits<RawType>::max());
+        }
+        if (result < std::numeric_limits<RawType>::min())
+        {
+            return FromRaw(std::numeric_limits<RawType>::min());
+        }
+        return FromRaw(static_cast<RawType>(result));
+    }
+    constexpr Fixed operator-() const { return Fixed() - *this; }
+    constexpr Fixed& operator+=(Fixed other) { return *this = *this + other; }
+    constexpr Fixed& operator-=(Fixed other) { return *this = *this - other; }
+    constexpr Fixed& operator*=(Fixed other) { return *this = *this * other; }
+    constexpr Fixed& operator/=(Fixed other) { return *this = *this / other; }
+
+    constexpr auto operator<=>(const Fixed& other) const = default;
+
+private:
+    RawType value_ = 0;
+};
+
+/**
+ * \brief IntegerSqrt is a constexpr function that computes the floor of the square root of an integer, bit by bit.
+ * It starts from the highest bit of the value and does not branch inside its loop.
+ */
+constexpr std::uint64_t IntegerSqrt(std::uint64_t value)
+{
+    if (value == 0)
+    {
+        return 0;
+    }
+    std::uint64_t result = 0;
+    std::uint64_t bit = std::uint64_t{ 1 } << ((63 - std::countl_zero(value)) & ~1);
+    while (bit != 0)
+    {
+        const std::uint64_t trial = result + bit;
+        const std::uint64_t mask = value >= trial ? ~std::uint64_t{ 0 } : 0;
+        value -= trial & mask;
+        result = (result >> 1u) + (bit & mask);
+        bit >>= 2u;
+    }
+    return result;
+}
+
+/**
+ * \brief Sqrt is the integer only square root of a fixed-point number, negative values give 0.
+ */
+constexpr Fixed Sqrt(Fixed value)
+{
+    if (value.GetRaw() <= 0)
+    {
+        return {};
+    }
+    //The square root of a 32.32 number is a 16.16 number
+    return Fixed::FromRaw(static_cast<Fixed::RawType>(
+        IntegerSqrt(static_cast<std::uint64_t>(value.GetRaw()) << Fixed::FRACTIONAL_BITS)));
+}
+
+/**
+ * \brief Vec2Fixed is the fixed-point equivalent of Vec2f, used by the game simulation in fixed-point mode.
+ */
+struct Vec2Fixed
+{
+    Fixed x, y;
+
+    constexpr Vec2Fixed() = default;
+    constexpr Vec2Fixed(Fixed newX, Fixed newY) : x(newX), y(newY)
+    {
+
+    }
+    constexpr explicit Vec2Fixed(Vec2f v) : x(v.x), y(v.y)
+    {
+
+    }
+    [[nodiscard]] constexpr Vec2f ToVec2f() const { return { x.ToFloat(), y.ToFloat() }; }
+
+    /**
+     * \brief GetSqrMagnitude is computed on 64 bits and saturates instead of overflowing.
+     */
+    [[nodiscard]] constexpr Fixed GetSqrMagnitude() const
+    {
+        const auto sqrMagnitude = GetRawSqrMagnitude() >> Fixed::FRACTIONAL_BITS;
+        return Fixed::FromRaw(sqrMagnitude > std::numeric_limits<Fixed::RawType>::max() ?
+            std::numeric_limits<Fixed::RawType>::max() : static_cast<Fixed::RawType>(sqrMagnitude));
+    }
+    [[nodiscard]] constexpr Fixed GetMagnitude() const
+    {
+        return Fixed::FromRaw(static_cast<Fixed::RawType>(IntegerSqrt(GetRawSqrMagnitude())));
+    }
+    constexpr void Normalize()
+    {
+        *this = GetNormalized();
+    }
+    /**
+     * \brief GetNormalized gives a zero vector for a zero vector, instead of the NaN of Vec2f.
+     * It divides once for a 32 bits reciprocal of the magnitude, the components never exceed the magnitude so their products fit in 64 bits.
+     */
+    [[nodiscard]] constexpr Vec2Fixed GetNormalized() const
+    {
+        const auto magnitude = static_cast<std::int64_t>(IntegerSqrt(GetRawSqrMagnitude()));
+        if (magnitude == 0)
+        {
+            return {};
+        }
+        const std::int64_t reciprocal = (std::int64_t{ 1 } << 48) / magnitude;
+        return {
+            Fixed::FromRaw(static_cast<Fixed::RawType>((x.GetRaw() * reciprocal) >> 32)),
+            Fixed::FromRaw(static_cast<Fixed::RawType>((y.GetRaw() * reciprocal) >> 32)) };
+    }
+    static constexpr Fixed Dot(Vec2Fixed a, Vec2Fixed b)
+    {
+        return Fixed::FromRaw(static_cast<Fixed::RawType>(
+            (static_cast<std::int64_t>(a.x.GetRaw()) * b.x.GetRaw() +
+                static_cast<std::int64_t>(a.y.GetRaw()) * b.y.GetRaw()) >> Fixed::FRACTIONAL_BITS));
+    }
+    [[nodiscard]] constexpr Vec2Fixed RightOrtho() const { return { y, -x }; }
+
+    constexpr Vec2Fixed operator+(Vec2Fixed v) const { return { x + v.x, y + v.y }; }
+    constexpr Vec2Fixed& operator+=(Vec2Fixed v) { return *this = *this + v; }
+    constexpr Vec2Fixed operator-(Vec2Fixed v) const { return { x - v.x, y - v.y }; }
+    constexpr Vec2Fixed& operator-=(Vec2Fixed v) { return *this = *this - v; }
+    constexpr Vec2Fixed operator*(Fixed f) const { return { x * f, y * f }; }
+    constexpr Vec2Fixed operator/(Fixed f) const { return { x / f, y / f }; }
+    constexpr bool operator==(const Vec2Fixed& other) const = default;
+
+    static constexpr Vec2Fixed zero() { return {}; }
+    static constexpr Vec2Fixed one() { return { 1, 1 }; }
+    static constexpr Vec2Fixed up() { return { 0, 1 }; }
+    static constexpr Vec2Fixed down() { return { 0, -1 }; }
+    static constexpr Vec2Fixed left() { return { -1, 0 }; }
+    static constexpr Vec2Fixed right() { return { 1, 0 }; }
+
+private:
+    [[nodiscard]] constexpr std::uint64_t GetRawSqrMagnitude() const
+    {
+        return static_cast<std::uint64_t>(static_cast<std::int64_t>(x.GetRaw()) * x.GetRaw()) +
+            static_cast<std::uint64_t>(static_cast<std::int64_t>(y.GetRaw()) * y.GetRaw());
+    }
+};
+
+constexpr Vec2Fixed operator*(Fixed f, Vec2Fixed v)
+{
+    return v * f;
+}
+}
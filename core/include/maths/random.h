@@ -0,0 +1,104 @@
+/**
+ * \file random.h
+ */
+#pragma once
+
+#include <cstdint>
+#include <type_traits>
+
+namespace core
+{
+/**
+ * \brief Pcg32 is a small and fast deterministic pseudo-random number generator (PCG XSH RR 64/32).
+ * Contrary to std::mt19937, its whole state fits in 16 bytes, so it can be stored in a rollback snapshot
+ * and give the same numbers when a frame is simulated again.
+ */
+struct Pcg32
+{
+    std::uint64_t state = 0x853c49e6748fea9bull;
+    std::uint64_t increment = 0xda3e39cb94b95bdbull;
+
+    constexpr Pcg32() = default;
+    constexpr explicit Pcg32(std::uint64_t seed, std::uint64_t sequence = DEFAULT_SEQUENCE)
+    {
+        Seed(seed, sequence);
+    }
+
+    /**
+     * \brief Seed is a method that resets the generator state.
+     * \param seed is the starting state
+     * \param sequence selects one of the 2^63 independent streams
+     */
+    constexpr void Seed(std::uint64_t seed, std::uint64_t sequence = DEFAULT_SEQUENCE)
+    {
+        state = 0u;
+        increment = (sequence << 1u) | 1u;
+        Next();
+        state += seed;
+        Next();
+    }
+
+    /**
+     * \brief Next is a method that returns a uniformly distributed 32 bits number and advances the state.
+     */
+    constexpr std::uint32_t Next()
+    {
+        const std::uint64_t oldState = state;
+        state = oldState * MULTIPLIER + increment;
+        const auto xorShifted = static_cast<std::uint32_t>(((oldState >> 18u) ^ oldState) >> 27u);
+        const auto rotation = static_cast<std::uint32_t>(oldState >> 59u);
+        return (xorShifted >> rotation) | (xorShifted << ((~rotation + 1u) & 31u));
+    }
+
+    /**
+     * \brief NextBounded is a method that returns a uniformly distributed number in [0, bound) without modulo bias.
+     */
+    constexpr std::uint32_t NextBounded(std::uint32_t bound)
+    {
+        if (bound == 0u)
+            return 0u;
+        const std::uint32_t threshold = (~bound + 1u) % bound;
+        while (true)
+        {
+            const std::uint32_t value = Next();
+            if (value >= threshold)
+                return value % bound;
+        }
+    }
+
+    /**
+     * \brief NextFloat is a method that returns a uniformly distributed float in [0, 1).
+     */
+    constexpr float NextFloat()
+    {
+        return static_cast<float>(Next() >> 8u) * (1.0f / 16777216.0f);
+    }
+
+    /**
+     * \brief RandomRange is the deterministic equivalent of core::RandomRange.
+     * \return an integer in [start, end] or a floating point value in [start, end)
+     */
+    template<typename T>
+    constexpr T RandomRange(T start, T end)
+    {
+        static_assert(std::is_arithmetic_v<T>);
+        if constexpr (std::is_integral_v<T>)
+        {
+            const auto range = static_cast<std::uint32_t>(end - start) + 1u;
+            //The range covers all the 32 bits values
+            if (range == 0u)
+                return static_cast<T>(start + static_cast<T>(Next()));
+            return static_cast<T>(start + static_cast<T>(NextBounded(range)));
+        }
+        else
+        {
+            return start + static_cast<T>(NextFloat()) * (end - start);
+        }
+    }
+
+    constexpr bool operator==(const Pcg32& other) const = default;
+
+    static constexpr std::uint64_t MULTIPLIER = 6364136223846793005ull;
+    static constexpr std::uint64_t DEFAULT_SEQUENCE = 54u;
+};
+}
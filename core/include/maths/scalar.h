@@ -0,0 +1,52 @@
+/**
+ * \file scalar.h
+ */
+#pragma once
+
+#include "maths/fixed.h"
+#include "maths/vec2.h"
+
+#include <cmath>
+
+namespace core
+{
+/**
+ * \brief Scalar and Vec2s are the number and vector types of the game simulation.
+ * They are fixed-point when GPR_FIXED_POINT is defined, so that the simulation does not depend on the floating point code generation,
+ * and float otherwise.
+ */
+#ifdef GPR_FIXED_POINT
+using Scalar = Fixed;
+using Vec2s = Vec2Fixed;
+#else
+using Scalar = float;
+using Vec2s = Vec2f;
+#endif
+
+/**
+ * \brief ToFloat converts a simulation value for rendering and logging.
+ */
+constexpr float ToFloat(float value)
+{
+    return value;
+}
+constexpr float ToFloat(Fixed value)
+{
+    return value.ToFloat();
+}
+constexpr Vec2f ToVec2f(Vec2f value)
+{
+    return value;
+}
+constexpr Vec2f ToVec2f(Vec2Fixed value)
+{
+    return value.ToVec2f();
+}
+/**
+ * \brief Sqrt is the square root of a float simulation value, the fixed-point one is in fixed.h.
+ */
+inline float Sqrt(float value)
+{
+    return std::sqrt(value);
+}
+}
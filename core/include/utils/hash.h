@@ -0,0 +1,48 @@
+/**
+ * \file hash.h
+ */
+#pragma once
+
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <type_traits>
+
+namespace core
+{
+/**
+ * \brief Fnv1aHash is a class that computes a 64 bits FNV-1a hash, incrementally.
+ * It is used to compare game states bit for bit, so floating point values are hashed by their representation.
+ */
+class Fnv1aHash
+{
+public:
+    constexpr void Add(std::span<const std::byte> bytes)
+    {
+        for (const auto byte : bytes)
+        {
+            value_ = (value_ ^ static_cast<std::uint64_t>(byte)) * PRIME;
+        }
+    }
+    /**
+     * \brief Add is a method that hashes a scalar value.
+     * Structs are hashed member by member by the caller, so that their padding bytes never change the hash.
+     */
+    template<typename T>
+    constexpr void Add(T value)
+    {
+        static_assert(std::is_arithmetic_v<T> || std::is_enum_v<T> || std::has_unique_object_representations_v<T>,
+            "Only scalar values or values without padding can be hashed");
+        const auto bytes = std::bit_cast<std::array<std::byte, sizeof(T)>>(value);
+        Add(std::span<const std::byte>(bytes));
+    }
+    [[nodiscard]] constexpr std::uint64_t GetValue() const { return value_; }
+
+    static constexpr std::uint64_t OFFSET_BASIS = 14695981039346656037ull;
+    static constexpr std::uint64_t PRIME = 1099511628211ull;
+private:
+    std::uint64_t value_ = OFFSET_BASIS;
+};
+}
@@ -0,0 +1,44 @@
+/**
+ * \file mapped_file.h
+ */
+#pragma once
+
+#include <cstddef>
+#include <span>
+#include <string_view>
+
+namespace core
+{
+/**
+ * \brief MappedFile is a class that maps a whole file in read-only memory, so that its content can be read without copying it.
+ */
+class MappedFile
+{
+public:
+    MappedFile() = default;
+    explicit MappedFile(std::string_view path) { Open(path); }
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+    MappedFile(MappedFile&& other) noexcept;
+    MappedFile& operator=(MappedFile&& other) noexcept;
+
+    /**
+     * \brief Open is a method that maps the file, closing the previously mapped one.
+     * \return true if the file is mapped
+     */
+    bool Open(std::string_view path);
+    void Close();
+    [[nodiscard]] bool IsOpen() const { return data_ != nullptr; }
+    [[nodiscard]] std::span<const std::byte> GetData() const { return { data_, size_ }; }
+
+private:
+    const std::byte* data_ = nullptr;
+    std::size_t size_ = 0;
+#ifdef _WIN32
+    void* fileHandle_ = nullptr;
+    void* mappingHandle_ = nullptr;
+#endif
+};
+}
@@ -0,0 +1,184 @@
+/**
+ * \file serialization.h
+ */
+#pragma once
+
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <span>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+namespace core
+{
+static_assert(std::endian::native == std::endian::little, "Binary blocks are stored in little endian");
+
+/**
+ * \brief BinaryMagic is the four characters identifying the kind of binary file.
+ */
+using BinaryMagic = std::array<char, 4>;
+
+/**
+ * \brief BinaryHeader is the header at the start of every binary buffer written by a BinaryWriter.
+ */
+struct BinaryHeader
+{
+    BinaryMagic magic{};
+    std::uint32_t version = 0;
+    std::uint32_t blockCount = 0;
+    std::uint32_t reserved = 0;
+};
+
+/**
+ * \brief BinaryBlockHeader precedes each block of trivially copyable elements.
+ * The block data starts right after the header and is padded to BINARY_ALIGNMENT.
+ */
+struct BinaryBlockHeader
+{
+    std::uint32_t id = 0;
+    std::uint32_t elementSize = 0;
+    std::uint64_t count = 0;
+};
+
+/**
+ * \brief BINARY_ALIGNMENT is the alignment of every header and block data, so that blocks can be read in place.
+ */
+constexpr std::size_t BINARY_ALIGNMENT = 8;
+static_assert(sizeof(BinaryHeader) % BINARY_ALIGNMENT == 0);
+static_assert(sizeof(BinaryBlockHeader) % BINARY_ALIGNMENT == 0);
+
+constexpr std::size_t AlignBinarySize(std::size_t size)
+{
+    return (size + BINARY_ALIGNMENT - 1) / BINARY_ALIGNMENT * BINARY_ALIGNMENT;
+}
+
+/**
+ * \brief BinaryWriter is a class that writes a versioned binary buffer made of blocks of trivially copyable elements.
+ */
+class BinaryWriter
+{
+public:
+    BinaryWriter(BinaryMagic magic, std::uint32_t version)
+    {
+        BinaryHeader header;
+        header.magic = magic;
+        header.version = version;
+        Append(&header, sizeof(header));
+    }
+
+    /**
+     * \brief WriteBlock is a method that appends a block of elements to the buffer.
+     * \param id is the identifier of the block, used to find it back when reading
+     * \param data is the array of elements to copy
+     */
+    template<typename T>
+    void WriteBlock(std::uint32_t id, std::span<const T> data)
+    {
+        static_assert(std::is_trivially_copyable_v<T>, "Only trivially copyable types can be written in binary blocks");
+        static_assert(alignof(T) <= BINARY_ALIGNMENT);
+        BinaryBlockHeader blockHeader;
+        blockHeader.id = id;
+        blockHeader.elementSize = static_cast<std::uint32_t>(sizeof(T));
+        blockHeader.count = data.size();
+        Append(&blockHeader, sizeof(blockHeader));
+        Append(data.data(), data.size_bytes());
+        buffer_.resize(AlignBinarySize(buffer_.size()));
+
+        auto* header = reinterpret_cast<BinaryHeader*>(buffer_.data());
+        header->blockCount++;
+    }
+    template<typename T>
+    void WriteBlock(std::uint32_t id, const std::vector<T>& data)
+    {
+        WriteBlock(id, std::span<const T>(data));
+    }
+    template<typename T>
+    void WriteValue(std::uint32_t id, const T& value)
+    {
+        WriteBlock(id, std::span<const T>(&value, 1));
+    }
+
+    [[nodiscard]] const std::vector<std::byte>& GetBuffer() const { return buffer_; }
+    [[nodiscard]] std::vector<std::byte>& GetBuffer() { return buffer_; }
+    /**
+     * \brief WriteToFile is a method that writes the whole buffer in a binary file.
+     * \return true if the file was written
+     */
+    bool WriteToFile(std::string_view path) const;
+
+private:
+    void Append(const void* data, std::size_t size)
+    {
+        const auto offset = buffer_.size();
+        buffer_.resize(offset + size);
+        if (size > 0)
+        {
+            std::memcpy(buffer_.data() + offset, data, size);
+        }
+    }
+    std::vector<std::byte> buffer_;
+};
+
+/**
+ * \brief BinaryView is a class that reads a buffer written by a BinaryWriter without copying it.
+ * The buffer can be a memory mapped file or a received network buffer, it must outlive the view and be aligned on BINARY_ALIGNMENT.
+ * Unknown blocks are ignored, so newer writers can add blocks without breaking older readers.
+ */
+class BinaryView
+{
+public:
+    BinaryView() = default;
+    /**
+     * \param buffer is the buffer to read
+     * \param magic is the expected magic of the buffer
+     * \param maxVersion is the latest version that the reader understands
+     */
+    BinaryView(std::span<const std::byte> buffer, BinaryMagic magic, std::uint32_t maxVersion);
+
+    /**
+     * \brief IsValid is a method that checks that the header and all the blocks are inside the buffer.
+     */
+    [[nodiscard]] bool IsValid() const { return isValid_; }
+    [[nodiscard]] std::uint32_t GetVersion() const { return version_; }
+    [[nodiscard]] std::span<const std::byte> GetBuffer() const { return buffer_; }
+
+    /**
+     * \brief GetBlock is a method that gives the elements of a block directly from the buffer.
+     * \return the elements, or an empty span if the block does not exist or has a different element size
+     */
+    template<typename T>
+    [[nodiscard]] std::span<const T> GetBlock(std::uint32_t id) const
+    {
+        static_assert(std::is_trivially_copyable_v<T>);
+        const auto* blockHeader = FindBlock(id);
+        if (blockHeader == nullptr || blockHeader->elementSize != sizeof(T))
+        {
+            return {};
+        }
+        const auto* data = reinterpret_cast<const std::byte*>(blockHeader) + sizeof(BinaryBlockHeader);
+        return { reinterpret_cast<const T*>(data), static_cast<std::size_t>(blockHeader->count) };
+    }
+    /**
+     * \brief GetValue is a method that reads a block containing a single value.
+     * \return a pointer to the value inside the buffer, or nullptr if it does not exist
+     */
+    template<typename T>
+    [[nodiscard]] const T* GetValue(std::uint32_t id) const
+    {
+        const auto block = GetBlock<T>(id);
+        return block.size() == 1 ? block.data() : nullptr;
+    }
+
+private:
+    [[nodiscard]] const BinaryBlockHeader* FindBlock(std::uint32_t id) const;
+
+    std::span<const std::byte> buffer_;
+    std::uint32_t version_ = 0;
+    std::uint32_t blockCount_ = 0;
+    bool isValid_ = false;
+};
+}
@@ -71,6 +71,16 @@ std::size_t EntityManager::GetEntitiesSize() const
     return entityMasks_.size();
 }
 
+const std::vector<EntityMask>& EntityManager::GetAllEntityMasks() const
+{
+    return entityMasks_;
+}
+
+void EntityManager::CopyAllEntityMasks(std::span<const EntityMask> entityMasks)
+{
+    entityMasks_.assign(entityMasks.begin(), entityMasks.end());
+}
+
 bool EntityManager::HasComponent(Entity entity, EntityMask mask) const
 {
     gpr_assert(entity != INVALID_ENTITY, "Invalid Entity");
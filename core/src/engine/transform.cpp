@@ -1,5 +1,7 @@
 #include <engine/transform.h>
 
+#include <algorithm>
+
 namespace core
 {
 void ScaleManager::AddComponent(Entity entity)
@@ -38,7 +40,11 @@ const std::vector<Degree>& TransformManager::GetAllRotations() const
 
 void TransformManager::SetPosition(Entity entity, Vec2f position)
 {
+    const auto currentPosition = positionManager_.GetComponent(entity);
+    if (currentPosition.x == position.x && currentPosition.y == position.y)
+        return;
     positionManager_.SetComponent(entity, position);
+    SetDirty(entity);
 }
 
 Vec2f TransformManager::GetScale(Entity entity) const
@@ -48,7 +54,11 @@ Vec2f TransformManager::GetScale(Entity entity) const
 
 void TransformManager::SetScale(Entity entity, Vec2f scale)
 {
+    const auto currentScale = scaleManager_.GetComponent(entity);
+    if (currentScale.x == scale.x && currentScale.y == scale.y)
+        return;
     scaleManager_.SetComponent(entity, scale);
+    SetDirty(entity);
 }
 
 Degree TransformManager::GetRotation(Entity entity) const
@@ -58,7 +68,10 @@ Degree TransformManager::GetRotation(Entity entity) const
 
 void TransformManager::SetRotation(Entity entity, Degree rotation)
 {
+    if (rotationManager_.GetComponent(entity).value() == rotation.value())
+        return;
     rotationManager_.SetComponent(entity, rotation);
+    SetDirty(entity);
 }
 
 void TransformManager::AddComponent(Entity entity)
@@ -66,6 +79,7 @@ void TransformManager::AddComponent(Entity entity)
     positionManager_.AddComponent(entity);
     scaleManager_.AddComponent(entity);
     rotationManager_.AddComponent(entity);
+    SetDirty(entity);
 }
 
 void TransformManager::RemoveComponent(Entity entity)
@@ -74,4 +88,36 @@ void TransformManager::RemoveComponent(Entity entity)
     scaleManager_.AddComponent(entity);
     rotationManager_.AddComponent(entity);
 }
+
+void TransformManager::CopyAllComponents(std::span<const Vec2f> positions, std::span<const Vec2f> scales, std::span<const Degree> rotations)
+{
+    positionManager_.CopyAllComponents(positions);
+    scaleManager_.CopyAllComponents(scales);
+    rotationManager_.CopyAllComponents(rotations);
+    for (Entity entity = 0; entity < positions.size(); entity++)
+    {
+        SetDirty(entity);
+    }
+}
+
+void TransformManager::ClearDirtyEntities()
+{
+    for (const auto entity : dirtyEntities_)
+    {
+        dirtyFlags_[entity] = false;
+    }
+    dirtyEntities_.clear();
+}
+
+void TransformManager::SetDirty(Entity entity)
+{
+    if (entity >= dirtyFlags_.size())
+    {
+        dirtyFlags_.resize(std::max<std::size_t>(entity + 1, dirtyFlags_.size() * 2));
+    }
+    if (dirtyFlags_[entity])
+        return;
+    dirtyFlags_[entity] = true;
+    dirtyEntities_.push_back(entity);
+}
 }
@@ -0,0 +1,136 @@
+#include "utils/mapped_file.h"
+#include "utils/log.h"
+
+#include <fmt/format.h>
+#include <string>
+#include <utility>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <Windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace core
+{
+
+MappedFile::~MappedFile()
+{
+    Close();
+}
+
+MappedFile::MappedFile(MappedFile&& other) noexcept
+{
+    *this = std::move(other);
+}
+
+MappedFile& MappedFile::operator=(MappedFile&& other) noexcept
+{
+    if (this != &other)
+    {
+        Close();
+        std::swap(data_, other.data_);
+        std::swap(size_, other.size_);
+#ifdef _WIN32
+        std::swap(fileHandle_, other.fileHandle_);
+        std::swap(mappingHandle_, other.mappingHandle_);
+#endif
+    }
+    return *this;
+}
+
+bool MappedFile::Open(std::string_view path)
+{
+    Close();
+    const std::string pathStr(path);
+#ifdef _WIN32
+    fileHandle_ = CreateFileA(pathStr.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+        OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (fileHandle_ == INVALID_HANDLE_VALUE)
+    {
+        fileHandle_ = nullptr;
+        LogError(fmt::format("Could not open file to map: {}", path));
+        return false;
+    }
+    LARGE_INTEGER fileSize{};
+    if (!GetFileSizeEx(fileHandle_, &fileSize) || fileSize.QuadPart == 0)
+    {
+        LogError(fmt::format("Could not map empty file: {}", path));
+        Close();
+        return false;
+    }
+    mappingHandle_ = CreateFileMappingA(fileHandle_, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (mappingHandle_ == nullptr)
+    {
+        LogError(fmt::format("Could not create file mapping: {}", path));
+        Close();
+        return false;
+    }
+    data_ = static_cast<const std::byte*>(MapViewOfFile(mappingHandle_, FILE_MAP_READ, 0, 0, 0));
+    if (data_ == nullptr)
+    {
+        LogError(fmt::format("Could not map file: {}", path));
+        Close();
+        return false;
+    }
+    size_ = static_cast<std::size_t>(fileSize.QuadPart);
+#else
+    const int fd = open(pathStr.c_str(), O_RDONLY);
+    if (fd < 0)
+    {
+        LogError(fmt::format("Could not open file to map: {}", path));
+        return false;
+    }
+    struct stat fileStat {};
+    if (fstat(fd, &fileStat) != 0 || fileStat.st_size == 0)
+    {
+        LogError(fmt::format("Could not map empty file: {}", path));
+        close(fd);
+        return false;
+    }
+    void* data = mmap(nullptr, static_cast<std::size_t>(fileStat.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+    //The mapping stays valid after closing the file descriptor
+    close(fd);
+    if (data == MAP_FAILED)
+    {
+        LogError(fmt::format("Could not map file: {}", path));
+        return false;
+    }
+    data_ = static_cast<const std::byte*>(data);
+    size_ = static_cast<std::size_t>(fileStat.st_size);
+#endif
+    return true;
+}
+
+void MappedFile::Close()
+{
+#ifdef _WIN32
+    if (data_ != nullptr)
+    {
+        UnmapViewOfFile(data_);
+    }
+    if (mappingHandle_ != nullptr)
+    {
+        CloseHandle(mappingHandle_);
+    }
+    if (fileHandle_ != nullptr)
+    {
+        CloseHandle(fileHandle_);
+    }
+    fileHandle_ = nullptr;
+    mappingHandle_ = nullptr;
+#else
+    if (data_ != nullptr)
+    {
+        munmap(const_cast<std::byte*>(data_), size_);
+    }
+#endif
+    data_ = nullptr;
+    size_ = 0;
+}
+}
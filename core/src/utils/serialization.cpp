@@ -0,0 +1,80 @@
+#include "utils/serialization.h"
+#include "utils/log.h"
+
+#include <fmt/format.h>
+#include <fstream>
+#include <string>
+
+namespace core
+{
+
+bool BinaryWriter::WriteToFile(std::string_view path) const
+{
+    std::ofstream file(std::string(path), std::ios::binary | std::ios::trunc);
+    if (!file)
+    {
+        LogError(fmt::format("Could not open binary file for writing: {}", path));
+        return false;
+    }
+    file.write(reinterpret_cast<const char*>(buffer_.data()), static_cast<std::streamsize>(buffer_.size()));
+    return static_cast<bool>(file);
+}
+
+BinaryView::BinaryView(std::span<const std::byte> buffer, BinaryMagic magic, std::uint32_t maxVersion) :
+    buffer_(buffer)
+{
+    if (buffer_.size() < sizeof(BinaryHeader) ||
+        reinterpret_cast<std::uintptr_t>(buffer_.data()) % BINARY_ALIGNMENT != 0)
+    {
+        return;
+    }
+    const auto* header = reinterpret_cast<const BinaryHeader*>(buffer_.data());
+    if (header->magic != magic || header->version == 0 || header->version > maxVersion)
+    {
+        return;
+    }
+    //Check that all the blocks are inside the buffer, so the accessors do not have to
+    std::size_t offset = sizeof(BinaryHeader);
+    for (std::uint32_t i = 0; i < header->blockCount; i++)
+    {
+        if (offset + sizeof(BinaryBlockHeader) > buffer_.size())
+        {
+            return;
+        }
+        const auto* blockHeader = reinterpret_cast<const BinaryBlockHeader*>(buffer_.data() + offset);
+        offset += sizeof(BinaryBlockHeader);
+        if (blockHeader->elementSize != 0 &&
+            blockHeader->count > (buffer_.size() - offset) / blockHeader->elementSize)
+        {
+            return;
+        }
+        offset = AlignBinarySize(offset + blockHeader->count * blockHeader->elementSize);
+        if (offset > buffer_.size())
+        {
+            return;
+        }
+    }
+    version_ = header->version;
+    blockCount_ = header->blockCount;
+    isValid_ = true;
+}
+
+const BinaryBlockHeader* BinaryView::FindBlock(std::uint32_t id) const
+{
+    if (!isValid_)
+    {
+        return nullptr;
+    }
+    std::size_t offset = sizeof(BinaryHeader);
+    for (std::uint32_t i = 0; i < blockCount_; i++)
+    {
+        const auto* blockHeader = reinterpret_cast<const BinaryBlockHeader*>(buffer_.data() + offset);
+        if (blockHeader->id == id)
+        {
+            return blockHeader;
+        }
+        offset = AlignBinarySize(offset + sizeof(BinaryBlockHeader) + blockHeader->count * blockHeader->elementSize);
+    }
+    return nullptr;
+}
+}
@@ -43,4 +43,21 @@ TEST(Entity, EntityComponent)
     entityManager.DestroyEntity(newEntity);
     EXPECT_FALSE(entityManager.HasComponent(newEntity, newComponent));
     EXPECT_FALSE(entityManager.HasComponent(newEntity, newComponent2));
-}
\ No newline at end of file
+}
+
+TEST(Entity, CopyAllEntityMasks)
+{
+    static constexpr core::Component newComponent = 2u;
+    core::EntityManager entityManager;
+    const auto entity1 = entityManager.CreateEntity();
+    const auto entity2 = entityManager.CreateEntity();
+    entityManager.AddComponent(entity2, newComponent);
+    const auto entityMasks = entityManager.GetAllEntityMasks();
+
+    core::EntityManager otherEntityManager(4);
+    otherEntityManager.CopyAllEntityMasks(entityMasks);
+    EXPECT_EQ(entityManager.GetEntitiesSize(), otherEntityManager.GetEntitiesSize());
+    EXPECT_TRUE(otherEntityManager.EntityExists(entity1));
+    EXPECT_FALSE(otherEntityManager.HasComponent(entity1, newComponent));
+    EXPECT_TRUE(otherEntityManager.HasComponent(entity2, newComponent));
+}
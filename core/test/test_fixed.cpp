@@ -0,0 +1,56 @@
+#include "maths/fixed.h"
+#include <gtest/gtest.h>
+
+#include <cmath>
+
+TEST(Fixed, Arithmetic)
+{
+    const core::Fixed a = 1.5f;
+    const core::Fixed b = -0.25f;
+    EXPECT_EQ(core::Fixed::ONE * 3 / 2, a.GetRaw());
+    EXPECT_FLOAT_EQ(1.25f, (a + b).ToFloat());
+    EXPECT_FLOAT_EQ(1.75f, (a - b).ToFloat());
+    EXPECT_FLOAT_EQ(-0.375f, (a * b).ToFloat());
+    EXPECT_FLOAT_EQ(-6.0f, (a / b).ToFloat());
+    EXPECT_FLOAT_EQ(-1.5f, (-a).ToFloat());
+    EXPECT_LT(b, a);
+    EXPECT_EQ(core::Fixed(2), a + 0.5f);
+}
+
+TEST(Fixed, DivisionSaturates)
+{
+    const core::Fixed one = 1;
+    EXPECT_EQ(std::numeric_limits<core::Fixed::RawType>::max(), (one / core::Fixed()).GetRaw());
+    EXPECT_EQ(std::numeric_limits<core::Fixed::RawType>::min(), (-one / core::Fixed()).GetRaw());
+    EXPECT_EQ(std::numeric_limits<core::Fixed::RawType>::max(), (core::Fixed(30000) / core::Fixed(0.001f)).GetRaw());
+}
+
+TEST(Fixed, Sqrt)
+{
+    EXPECT_EQ(core::Fixed(3), core::Sqrt(core::Fixed(9)));
+    EXPECT_EQ(core::Fixed(0.5f), core::Sqrt(core::Fixed(0.25f)));
+    EXPECT_EQ(core::Fixed(), core::Sqrt(core::Fixed(-4)));
+    for (int i = 1; i < 1000; i++)
+    {
+        const core::Fixed value = static_cast<float>(i) * 0.37f;
+        EXPECT_NEAR(std::sqrt(value.ToFloat()), core::Sqrt(value).ToFloat(), 1.0f / core::Fixed::ONE);
+    }
+}
+
+TEST(Fixed, Vec2)
+{
+    const core::Vec2Fixed v{ 3, -4 };
+    EXPECT_EQ(core::Fixed(5), v.GetMagnitude());
+    EXPECT_EQ(core::Fixed(25), v.GetSqrMagnitude());
+    EXPECT_EQ(core::Fixed(-1), core::Vec2Fixed::Dot(v, core::Vec2Fixed::one()));
+    const auto normalized = v.GetNormalized();
+    //The division truncates, so the components can be one step away from the rounded value
+    EXPECT_NEAR(0.6f, normalized.x.ToFloat(), 1.0f / core::Fixed::ONE);
+    EXPECT_NEAR(-0.8f, normalized.y.ToFloat(), 1.0f / core::Fixed::ONE);
+    EXPECT_EQ(core::Vec2Fixed::zero(), core::Vec2Fixed::zero().GetNormalized());
+    EXPECT_EQ(core::Vec2Fixed(-4, -3), v.RightOrtho());
+
+    //The magnitude is computed on 64 bits, so it does not overflow before the square root
+    const core::Vec2Fixed big{ 30000, 30000 };
+    EXPECT_NEAR(42426.4f * 0.5f, (big * 0.5f).GetMagnitude().ToFloat(), 0.01f);
+}
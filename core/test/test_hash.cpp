@@ -0,0 +1,34 @@
+#include "utils/hash.h"
+#include <gtest/gtest.h>
+
+#include <string_view>
+
+TEST(Hash, ReferenceValues)
+{
+    //Values of the FNV-1a 64 bits reference implementation
+    EXPECT_EQ(0xcbf29ce484222325ull, core::Fnv1aHash().GetValue());
+    core::Fnv1aHash hash;
+    hash.Add('a');
+    EXPECT_EQ(0xaf63dc4c8601ec8cull, hash.GetValue());
+
+    core::Fnv1aHash foobar;
+    for (const char c : std::string_view("foobar"))
+    {
+        foobar.Add(c);
+    }
+    EXPECT_EQ(0x85944171f73967e8ull, foobar.GetValue());
+}
+
+TEST(Hash, FloatRepresentation)
+{
+    core::Fnv1aHash positiveZero;
+    positiveZero.Add(0.0f);
+    core::Fnv1aHash negativeZero;
+    negativeZero.Add(-0.0f);
+    //Equal values with different bits give different hashes, as they can diverge later in the simulation
+    EXPECT_NE(positiveZero.GetValue(), negativeZero.GetValue());
+
+    core::Fnv1aHash sameValue;
+    sameValue.Add(0.0f);
+    EXPECT_EQ(positiveZero.GetValue(), sameValue.GetValue());
+}
@@ -0,0 +1,52 @@
+#include "maths/random.h"
+#include <gtest/gtest.h>
+
+#include <array>
+
+TEST(Random, ReferenceSequence)
+{
+    //Values of the PCG32 reference implementation seeded with 42 on sequence 54
+    constexpr std::array<std::uint32_t, 6> expected{
+        0xa15c02b7u, 0x7b47f409u, 0xba1d3330u, 0x83d2f293u, 0xbfa4784bu, 0xcbed606eu };
+    core::Pcg32 random(42u, 54u);
+    for (const auto value : expected)
+    {
+        EXPECT_EQ(value, random.Next());
+    }
+}
+
+TEST(Random, CopyRestoresSequence)
+{
+    core::Pcg32 random(1234u);
+    for (int i = 0; i < 10; i++)
+    {
+        random.Next();
+    }
+    const core::Pcg32 snapshot = random;
+    std::array<std::uint32_t, 16> values{};
+    for (auto& value : values)
+    {
+        value = random.Next();
+    }
+    random = snapshot;
+    EXPECT_EQ(snapshot, random);
+    for (const auto value : values)
+    {
+        EXPECT_EQ(value, random.Next());
+    }
+}
+
+TEST(Random, RandomRange)
+{
+    core::Pcg32 random(7u);
+    for (int i = 0; i < 1000; i++)
+    {
+        const auto integer = random.RandomRange(-3, 3);
+        EXPECT_GE(integer, -3);
+        EXPECT_LE(integer, 3);
+        const auto real = random.RandomRange(-1.0f, 2.0f);
+        EXPECT_GE(real, -1.0f);
+        EXPECT_LT(real, 2.0f);
+    }
+    EXPECT_EQ(5, random.RandomRange(5, 5));
+}
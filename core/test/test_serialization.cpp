@@ -0,0 +1,57 @@
+#include "utils/serialization.h"
+#include <gtest/gtest.h>
+
+#include "maths/vec2.h"
+
+namespace
+{
+constexpr core::BinaryMagic testMagic{ 'T', 'E', 'S', 'T' };
+constexpr std::uint32_t testVersion = 2;
+}
+
+TEST(Serialization, WriteAndReadBlocks)
+{
+    const std::vector<core::Vec2f> positions{ {1.0f, 2.0f}, {3.0f, 4.0f}, {5.0f, 6.0f} };
+    const std::uint8_t flag = 7u;
+    core::BinaryWriter writer(testMagic, testVersion);
+    writer.WriteBlock(1u, positions);
+    writer.WriteValue(2u, flag);
+    writer.WriteBlock(3u, std::vector<int>{});
+    EXPECT_EQ(0u, writer.GetBuffer().size() % core::BINARY_ALIGNMENT);
+
+    const core::BinaryView view(writer.GetBuffer(), testMagic, testVersion);
+    ASSERT_TRUE(view.IsValid());
+    EXPECT_EQ(testVersion, view.GetVersion());
+
+    const auto readPositions = view.GetBlock<core::Vec2f>(1u);
+    ASSERT_EQ(positions.size(), readPositions.size());
+    //The view reads in place without copying
+    EXPECT_GE(reinterpret_cast<const std::byte*>(readPositions.data()), writer.GetBuffer().data());
+    for (std::size_t i = 0; i < positions.size(); i++)
+    {
+        EXPECT_FLOAT_EQ(positions[i].x, readPositions[i].x);
+        EXPECT_FLOAT_EQ(positions[i].y, readPositions[i].y);
+    }
+    const auto* readFlag = view.GetValue<std::uint8_t>(2u);
+    ASSERT_NE(nullptr, readFlag);
+    EXPECT_EQ(flag, *readFlag);
+    EXPECT_TRUE(view.GetBlock<int>(3u).empty());
+    //Unknown block and wrong element size
+    EXPECT_TRUE(view.GetBlock<int>(4u).empty());
+    EXPECT_TRUE(view.GetBlock<std::uint16_t>(1u).empty());
+}
+
+TEST(Serialization, InvalidBuffers)
+{
+    core::BinaryWriter writer(testMagic, testVersion);
+    writer.WriteBlock(1u, std::vector<int>{ 1, 2, 3, 4 });
+    const auto& buffer = writer.GetBuffer();
+
+    EXPECT_FALSE(core::BinaryView(buffer, core::BinaryMagic{ 'N', 'O', 'P', 'E' }, testVersion).IsValid());
+    EXPECT_FALSE(core::BinaryView(buffer, testMagic, testVersion - 1).IsValid());
+    EXPECT_TRUE(core::BinaryView(buffer, testMagic, testVersion + 1).IsValid());
+    //Truncated buffer
+    const std::span<const std::byte> truncated(buffer.data(), buffer.size() - core::BINARY_ALIGNMENT);
+    EXPECT_FALSE(core::BinaryView(truncated, testMagic, testVersion).IsValid());
+    EXPECT_FALSE(core::BinaryView(std::span<const std::byte>{}, testMagic, testVersion).IsValid());
+}
@@ -0,0 +1,35 @@
+#include <engine/entity.h>
+#include <engine/transform.h>
+#include <gtest/gtest.h>
+
+TEST(Transform, DirtyEntities)
+{
+    core::EntityManager entityManager;
+    core::TransformManager transformManager(entityManager);
+
+    const auto entity1 = entityManager.CreateEntity();
+    const auto entity2 = entityManager.CreateEntity();
+    transformManager.AddComponent(entity1);
+    transformManager.AddComponent(entity2);
+    EXPECT_EQ(2, transformManager.GetDirtyEntities().size());
+    transformManager.ClearDirtyEntities();
+    EXPECT_TRUE(transformManager.GetDirtyEntities().empty());
+
+    //Setting the same value does not make the entity dirty
+    transformManager.SetPosition(entity1, transformManager.GetPosition(entity1));
+    transformManager.SetScale(entity1, core::Vec2f::one());
+    EXPECT_TRUE(transformManager.GetDirtyEntities().empty());
+
+    //An entity changed several times is only once in the dirty entities
+    transformManager.SetPosition(entity2, core::Vec2f(1.0f, 2.0f));
+    transformManager.SetRotation(entity2, core::Degree(45.0f));
+    transformManager.SetScale(entity2, core::Vec2f(2.0f, 2.0f));
+    ASSERT_EQ(1, transformManager.GetDirtyEntities().size());
+    EXPECT_EQ(entity2, transformManager.GetDirtyEntities()[0]);
+    EXPECT_FLOAT_EQ(45.0f, transformManager.GetRotation(entity2).value());
+
+    transformManager.ClearDirtyEntities();
+    transformManager.SetRotation(entity1, core::Degree(90.0f));
+    ASSERT_EQ(1, transformManager.GetDirtyEntities().size());
+    EXPECT_EQ(entity1, transformManager.GetDirtyEntities()[0]);
+}
@@ -0,0 +1,121 @@
+/**
+ * \file bench_scene.h
+ */
+#pragma once
+#include "game/game_globals.h"
+#include "game/physics_manager.h"
+#include "maths/random.h"
+
+#include <cstdint>
+#include <vector>
+
+namespace game
+{
+constexpr float BENCH_PLAYER_RADIUS = 0.5f;
+constexpr float BENCH_BULLET_RADIUS = 0.25f;
+/**
+ * \brief BENCH_BULLET_VERTICAL_SPEED is the maximum vertical speed of the scattered bullets, which fly mostly horizontally like the shot ones.
+ */
+constexpr float BENCH_BULLET_VERTICAL_SPEED = 0.5f;
+
+/**
+ * \brief ArenaScatter draws the random bodies of the benchmark scenes from RANDOM_SEED,
+ * so that every run of a benchmark simulates the same scene.
+ */
+class ArenaScatter
+{
+public:
+    [[nodiscard]] float NextRange(float min, float max) { return random_.RandomRange(min, max); }
+    /**
+     * \brief NextPosition gives a position in the arena limits.
+     */
+    [[nodiscard]] core::Vec2f NextPosition()
+    {
+        const float x = NextRange(LEFT_LIMIT, RIGHT_LIMIT);
+        const float y = NextRange(LOWER_LIMIT, UPPER_LIMIT);
+        return { x, y };
+    }
+    /**
+     * \brief NextPlayerVelocity gives a horizontal walking velocity.
+     */
+    [[nodiscard]] core::Vec2f NextPlayerVelocity()
+    {
+        return { NextRange(-PLAYER_SPEED, PLAYER_SPEED), 0.0f };
+    }
+    /**
+     * \brief NextBulletVelocity gives a bullet velocity, mostly horizontal.
+     */
+    [[nodiscard]] core::Vec2f NextBulletVelocity()
+    {
+        const float x = NextRange(-BULLET_SPEED, BULLET_SPEED);
+        const float y = NextRange(-BENCH_BULLET_VERTICAL_SPEED, BENCH_BULLET_VERTICAL_SPEED);
+        return { x, y };
+    }
+
+private:
+    core::Pcg32 random_{ RANDOM_SEED };
+};
+
+/**
+ * \brief PhysicsScene is a PhysicsManager populated like a crowded game: players walking in the arena,
+ * and continuous bullets without gravity flying mostly horizontally, scattered by an ArenaScatter.
+ * The players are the first entities, and each body can be followed by sprite only entities, like the entities of the game that are not simulated.
+ */
+class PhysicsScene
+{
+public:
+    PhysicsScene(std::int64_t playerNmb, std::int64_t bulletNmb, std::int64_t spriteNmbPerBody = 0) : physicsManager_(entityManager_)
+    {
+        ArenaScatter scatter;
+        for (std::int64_t i = 0; i < playerNmb + bulletNmb; i++)
+        {
+            const bool isPlayer = i < playerNmb;
+            const auto entity = entityManager_.CreateEntity();
+            Rigidbody body;
+            body.position = core::Vec2s(scatter.NextPosition());
+            CircleCollider circle;
+            if (isPlayer)
+            {
+                entityManager_.AddComponent(entity, static_cast<core::EntityMask>(ComponentType::PLAYER_CHARACTER));
+                body.velocity = core::Vec2s(scatter.NextPlayerVelocity());
+                circle.radius = BENCH_PLAYER_RADIUS;
+            }
+            else
+            {
+                entityManager_.AddComponent(entity, static_cast<core::EntityMask>(ComponentType::BULLET));
+                body.velocity = core::Vec2s(scatter.NextBulletVelocity());
+                body.gravityScale = 0.0f;
+                body.collisionDetection = CollisionDetection::CONTINUOUS;
+                circle.radius = BENCH_BULLET_RADIUS;
+            }
+            physicsManager_.AddRigidbody(entity);
+            physicsManager_.SetRigidbody(entity, body);
+            physicsManager_.AddCircle(entity);
+            physicsManager_.SetCircle(entity, circle);
+            for (std::int64_t sprite = 0; sprite < spriteNmbPerBody; sprite++)
+            {
+                const auto spriteEntity = entityManager_.CreateEntity();
+                entityManager_.AddComponent(spriteEntity, static_cast<core::EntityMask>(core::ComponentType::SPRITE));
+            }
+        }
+        initialBodies_ = physicsManager_.GetAllRigidbodies();
+        initialCircles_ = physicsManager_.GetAllCircles();
+    }
+    /**
+     * \brief Reset puts the bodies back to their initial state, before the bullets leave the arena
+     */
+    void Reset()
+    {
+        physicsManager_.CopyAllComponents(initialBodies_, initialCircles_);
+    }
+    [[nodiscard]] core::EntityManager& GetEntityManager() { return entityManager_; }
+    [[nodiscard]] PhysicsManager& GetPhysicsManager() { return physicsManager_; }
+    [[nodiscard]] const std::vector<Rigidbody>& GetInitialBodies() const { return initialBodies_; }
+
+private:
+    core::EntityManager entityManager_;
+    PhysicsManager physicsManager_;
+    std::vector<Rigidbody> initialBodies_;
+    std::vector<CircleCollider> initialCircles_;
+};
+}
@@ -0,0 +1,131 @@
+#include <benchmark/benchmark.h>
+
+#include "bench_scene.h"
+#include "game/broadphase.h"
+
+#include <type_traits>
+#include <vector>
+
+namespace
+{
+/**
+ * \brief BruteForceBroadphase is the double loop over all the colliders used before the broadphases, as a reference.
+ */
+class BruteForceBroadphase
+{
+public:
+    void FindPairs(std::span<const game::BroadphaseBody> bodies, std::vector<game::CollisionPair>& pairs)
+    {
+        pairs.clear();
+        for (std::size_t i = 0; i < bodies.size(); i++)
+        {
+            for (std::size_t j = i + 1; j < bodies.size(); j++)
+            {
+                const auto minBound1 = bodies[i].GetMinBound();
+                const auto maxBound1 = bodies[i].GetMaxBound();
+                const auto minBound2 = bodies[j].GetMinBound();
+                const auto maxBound2 = bodies[j].GetMaxBound();
+                if (!bodies[i].filter.CanCollide(bodies[j].filter) ||
+                    maxBound1.x < minBound2.x || maxBound2.x < minBound1.x ||
+                    maxBound1.y < minBound2.y || maxBound2.y < minBound1.y)
+                {
+                    continue;
+                }
+                pairs.push_back({ bodies[i].entity, bodies[j].entity,
+                    static_cast<std::uint32_t>(i), static_cast<std::uint32_t>(j) });
+            }
+        }
+    }
+};
+
+/**
+ * \brief Scene is a set of bullets moving mostly horizontally in the arena, like the shot bullets, bouncing on its limits.
+ */
+class Scene
+{
+public:
+    explicit Scene(std::int64_t bodyNmb)
+    {
+        game::ArenaScatter scatter;
+        bodies_.resize(static_cast<std::size_t>(bodyNmb));
+        velocities_.resize(bodies_.size());
+        for (std::size_t i = 0; i < bodies_.size(); i++)
+        {
+            bodies_[i].entity = static_cast<core::Entity>(i);
+            bodies_[i].position = core::Vec2s(scatter.NextPosition());
+            bodies_[i].radius = scatter.NextRange(0.1f, 0.77f);
+            velocities_[i] = core::Vec2s(scatter.NextBulletVelocity());
+        }
+    }
+    void Step()
+    {
+        const core::Scalar dt = game::FIXED_PERIOD;
+        for (std::size_t i = 0; i < bodies_.size(); i++)
+        {
+            auto& position = bodies_[i].position;
+            //The bullets are continuous colliders, their bounds cover their sweep
+            bodies_[i].displacement = velocities_[i] * dt;
+            position += bodies_[i].displacement;
+            if (position.x < game::LEFT_LIMIT || position.x > game::RIGHT_LIMIT)
+            {
+                velocities_[i].x = -velocities_[i].x;
+            }
+            if (position.y < game::LOWER_LIMIT || position.y > game::UPPER_LIMIT)
+            {
+                velocities_[i].y = -velocities_[i].y;
+            }
+        }
+    }
+    [[nodiscard]] std::span<const game::BroadphaseBody> GetBodies() const { return bodies_; }
+
+private:
+    std::vector<game::BroadphaseBody> bodies_;
+    std::vector<core::Vec2s> velocities_;
+};
+
+template<typename Broadphase>
+void BM_Broadphase(benchmark::State& state)
+{
+    Scene scene(state.range(0));
+    Broadphase broadphase;
+    std::vector<game::CollisionPair> pairs;
+    //All the broadphases must find the same pairs as the brute force
+    std::vector<game::CollisionPair> expectedPairs;
+    BruteForceBroadphase().FindPairs(scene.GetBodies(), expectedPairs);
+    broadphase.FindPairs(scene.GetBodies(), pairs);
+    if (pairs != expectedPairs)
+    {
+        state.SkipWithError("The broadphase pairs differ from the brute force pairs");
+        return;
+    }
+
+    std::size_t pairNmb = 0;
+    std::size_t swapNmb = 0;
+    for (auto _ : state)
+    {
+        scene.Step();
+        broadphase.FindPairs(scene.GetBodies(), pairs);
+        pairNmb += pairs.size();
+        if constexpr (std::is_same_v<Broadphase, game::SweepAndPruneBroadphase>)
+        {
+            swapNmb += broadphase.GetLastSwapCount();
+        }
+        benchmark::DoNotOptimize(pairs.data());
+        benchmark::ClobberMemory();
+    }
+    state.counters["bodies"] = benchmark::Counter(
+        static_cast<double>(state.range(0)) * static_cast<double>(state.iterations()), benchmark::Counter::kIsRate);
+    state.counters["pairs"] = benchmark::Counter(static_cast<double>(pairNmb), benchmark::Counter::kAvgIterations);
+    if constexpr (std::is_same_v<Broadphase, game::SweepAndPruneBroadphase>)
+    {
+        //Swaps of the insertion sort per frame, low when the order is reused from the previous frame
+        state.counters["swaps"] = benchmark::Counter(static_cast<double>(swapNmb), benchmark::Counter::kAvgIterations);
+    }
+}
+}
+
+BENCHMARK_TEMPLATE(BM_Broadphase, BruteForceBroadphase)->RangeMultiplier(4)->Range(16, 1024);
+BENCHMARK_TEMPLATE(BM_Broadphase, game::UniformGridBroadphase)->RangeMultiplier(4)->Range(16, 1024);
+BENCHMARK_TEMPLATE(BM_Broadphase, game::SweepAndPruneBroadphase)->RangeMultiplier(4)->Range(16, 1024);
+
+BENCHMARK_MAIN();
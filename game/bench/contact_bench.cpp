@@ -0,0 +1,68 @@
+#include <benchmark/benchmark.h>
+#include <spdlog/spdlog.h>
+
+#include "game/game_manager.h"
+
+#include <memory>
+
+namespace
+{
+/**
+ * \brief SetupCluster spawns all the players and a cluster of bulletNmb validated bullets overlapping each other,
+ * then advances the game by one frame, so that each simulation resimulates one frame with all the bullets in contact.
+ * The bullets alternate between two players: the pairs of bullets of the same player are pruned by the broadphase,
+ * the others are tested and dispatched each frame, the bullets they destroy are restored by the next rollback.
+ */
+void SetupCluster(game::HeadlessGameManager& gameManager, std::int64_t bulletNmb)
+{
+    for (game::PlayerNumber playerNumber = 0; playerNumber < game::MAX_PLAYER_NMB; playerNumber++)
+    {
+        gameManager.SpawnPlayer(playerNumber,
+            game::SPAWN_POSITIONS[playerNumber],
+            game::SPAWN_DIRECTION[playerNumber]);
+    }
+    constexpr int columnNmb = 8;
+    for (std::int64_t i = 0; i < bulletNmb; i++)
+    {
+        const core::Vec2f position{
+            static_cast<float>(i % columnNmb) * 0.05f,
+            game::UPPER_LIMIT - 2.0f - static_cast<float>(i / columnNmb % columnNmb) * 0.05f };
+        gameManager.SpawnValidatedBullet(static_cast<game::PlayerNumber>(i % 2), position, core::Vec2f::zero());
+    }
+    gameManager.AdvanceFrame();
+}
+}
+
+/**
+ * \brief BM_Contacts measures the cost of a simulated frame dominated by the contacts between bullets,
+ * the contacts counter gives the number of contacts found per second, the contacts of bullets destroyed earlier in the frame are not dispatched.
+ */
+static void BM_Contacts(benchmark::State& state)
+{
+    auto gameManager = std::make_unique<game::HeadlessGameManager>();
+    SetupCluster(*gameManager, state.range(0));
+    auto& rollbackManager = gameManager->GetRollbackManager();
+    rollbackManager.SimulateToCurrentFrame();
+    const auto contactNmb = rollbackManager.GetCurrentPhysicsManager().GetContacts().size();
+    for (auto _ : state)
+    {
+        rollbackManager.SimulateToCurrentFrame();
+    }
+    state.counters["contacts"] = benchmark::Counter(
+        static_cast<double>(contactNmb) * static_cast<double>(state.iterations()), benchmark::Counter::kIsRate);
+}
+BENCHMARK(BM_Contacts)->ArgName("bullets")->RangeMultiplier(2)->Range(16, 128);
+
+int main(int argc, char** argv)
+{
+    //Spawning logs would be mixed with the benchmark results
+    spdlog::set_level(spdlog::level::warn);
+    benchmark::Initialize(&argc, argv);
+    if (benchmark::ReportUnrecognizedArguments(argc, argv))
+    {
+        return 1;
+    }
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+    return 0;
+}
@@ -0,0 +1,166 @@
+#include <benchmark/benchmark.h>
+
+#include "bench_scene.h"
+
+#include <cstdint>
+
+namespace
+{
+/**
+ * \brief LegacyIntegration is the integration used before the fused pass, as a reference:
+ * a gravity pass and a player limit pass over all the entities, each copying the rigidbodies out and back by value.
+ */
+class LegacyIntegration
+{
+public:
+    LegacyIntegration(core::EntityManager& entityManager, game::RigidbodyManager& rigidbodyManager) :
+        entityManager_(entityManager), rigidbodyManager_(rigidbodyManager) {}
+    void Integrate(sf::Time dt)
+    {
+        ApplyGravityToRigidbodies(dt);
+        LimitPlayerMovement(dt);
+    }
+private:
+    void ApplyGravityToRigidbodies(sf::Time dt)
+    {
+        const core::Scalar dtSeconds = dt.asSeconds();
+        for (core::Entity entity = 0; entity < entityManager_.GetEntitiesSize(); entity++)
+        {
+            if (!entityManager_.HasComponent(entity, static_cast<core::EntityMask>(core::ComponentType::RIGIDBODY)))
+                continue;
+            auto rigidbody = rigidbodyManager_.GetComponent(entity);
+            if (rigidbody.position.y > game::LOWER_LIMIT && rigidbody.bodyType == game::BodyType::DYNAMIC)
+            {
+                rigidbody.velocity.y += (game::GRAVITY * rigidbody.gravityScale) * dtSeconds;
+            }
+            rigidbody.position += rigidbody.velocity * dtSeconds;
+            rigidbodyManager_.SetComponent(entity, rigidbody);
+        }
+    }
+    void LimitPlayerMovement(sf::Time dt)
+    {
+        const core::Scalar dtSeconds = dt.asSeconds();
+        for (core::Entity entity = 0; entity < entityManager_.GetEntitiesSize(); entity++)
+        {
+            if (!entityManager_.HasComponent(entity,
+                static_cast<core::EntityMask>(core::ComponentType::RIGIDBODY) |
+                static_cast<core::EntityMask>(game::ComponentType::PLAYER_CHARACTER)) ||
+                entityManager_.HasComponent(entity, static_cast<core::EntityMask>(game::ComponentType::DESTROYED)))
+                continue;
+            auto rigidbody = rigidbodyManager_.GetComponent(entity);
+            if (rigidbody.position.y < game::LOWER_LIMIT)
+            {
+                rigidbody.position.y = game::LOWER_LIMIT;
+            }
+            if (rigidbody.position.y > game::UPPER_LIMIT)
+            {
+                rigidbody.position.y = game::UPPER_LIMIT;
+            }
+            if (rigidbody.position.x > game::RIGHT_LIMIT)
+            {
+                rigidbody.position.x = game::RIGHT_LIMIT;
+            }
+            if (rigidbody.position.x < game::LEFT_LIMIT)
+            {
+                rigidbody.position.x = game::LEFT_LIMIT;
+            }
+            if (rigidbody.velocity.x > 0.0f || rigidbody.velocity.x < 0.0f)
+            {
+                rigidbody.velocity.x += (0.0f - rigidbody.velocity.x) * (dtSeconds * 2.0f);
+            }
+            rigidbodyManager_.SetComponent(entity, rigidbody);
+        }
+    }
+
+    core::EntityManager& entityManager_;
+    game::RigidbodyManager& rigidbodyManager_;
+};
+
+/**
+ * \brief Scene is a PhysicsScene whose rigidbodies are also copied in a RigidbodyManager for the legacy integration.
+ * Each body has a sprite only entity next to it, so that the legacy passes also go over entities that are not simulated.
+ */
+class Scene
+{
+public:
+    explicit Scene(std::int64_t bodyNmb) :
+        physicsScene_(game::MAX_PLAYER_NMB, bodyNmb - game::MAX_PLAYER_NMB, 1),
+        rigidbodyManager_(physicsScene_.GetEntityManager())
+    {
+        for (const auto entity : physicsScene_.GetPhysicsManager().GetDynamicBodies())
+        {
+            rigidbodyManager_.AddComponent(entity);
+            rigidbodyManager_.SetComponent(entity, physicsScene_.GetPhysicsManager().GetRigidbody(entity));
+        }
+    }
+    /**
+     * \brief Reset puts the bodies back to their initial state, so that the bullets stay in the range of the fixed-point values
+     */
+    void Reset()
+    {
+        rigidbodyManager_.CopyAllComponents(physicsScene_.GetInitialBodies());
+        physicsScene_.Reset();
+    }
+    [[nodiscard]] core::EntityManager& GetEntityManager() { return physicsScene_.GetEntityManager(); }
+    [[nodiscard]] game::RigidbodyManager& GetRigidbodyManager() { return rigidbodyManager_; }
+    [[nodiscard]] game::PhysicsManager& GetPhysicsManager() { return physicsScene_.GetPhysicsManager(); }
+
+private:
+    game::PhysicsScene physicsScene_;
+    game::RigidbodyManager rigidbodyManager_;
+};
+
+constexpr std::int64_t FRAMES_PER_RESET = 1024;
+
+void SetCounters(benchmark::State& state)
+{
+    state.counters["bodies"] = benchmark::Counter(
+        static_cast<double>(state.range(0)) * static_cast<double>(state.iterations()), benchmark::Counter::kIsRate);
+    //The bytes of simulation state updated per second, the fused pass reaches a higher rate by touching each body once
+    state.SetBytesProcessed(state.range(0) * static_cast<std::int64_t>(sizeof(game::Rigidbody)) * state.iterations());
+}
+}
+
+/**
+ * \brief BM_LegacyIntegration measures one fixed frame of the two by value passes over all the entities.
+ */
+static void BM_LegacyIntegration(benchmark::State& state)
+{
+    Scene scene(state.range(0));
+    LegacyIntegration integration(scene.GetEntityManager(), scene.GetRigidbodyManager());
+    std::int64_t frame = 0;
+    for (auto _ : state)
+    {
+        if (++frame % FRAMES_PER_RESET == 0)
+        {
+            scene.Reset();
+        }
+        integration.Integrate(sf::seconds(game::FIXED_PERIOD));
+        benchmark::ClobberMemory();
+    }
+    SetCounters(state);
+}
+BENCHMARK(BM_LegacyIntegration)->ArgName("bodies")->RangeMultiplier(4)->Range(64, 4096);
+
+/**
+ * \brief BM_FusedIntegration measures one fixed frame of the single in place pass over the dynamic bodies.
+ */
+static void BM_FusedIntegration(benchmark::State& state)
+{
+    Scene scene(state.range(0));
+    auto& physicsManager = scene.GetPhysicsManager();
+    std::int64_t frame = 0;
+    for (auto _ : state)
+    {
+        if (++frame % FRAMES_PER_RESET == 0)
+        {
+            scene.Reset();
+        }
+        physicsManager.IntegrateRigidbodies(sf::seconds(game::FIXED_PERIOD));
+        benchmark::ClobberMemory();
+    }
+    SetCounters(state);
+}
+BENCHMARK(BM_FusedIntegration)->ArgName("bodies")->RangeMultiplier(4)->Range(64, 4096);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,85 @@
+#include <benchmark/benchmark.h>
+
+#include "bench_scene.h"
+
+#include <cstdint>
+
+namespace
+{
+constexpr std::int64_t FRAMES_PER_RESET = 256;
+}
+
+/**
+ * \brief BM_PhysicsFixedUpdate measures one fixed update of the physics, integration and collision detection,
+ * with the number of narrowphase threads as the third argument.
+ * The pairs counter gives the candidate pairs tested by the narrowphase per frame, the contacts counter the contacts found per frame.
+ */
+static void BM_PhysicsFixedUpdate(benchmark::State& state)
+{
+    game::PhysicsScene scene(state.range(0), state.range(1));
+    auto& physicsManager = scene.GetPhysicsManager();
+    physicsManager.SetThreadCount(static_cast<std::size_t>(state.range(2)));
+    std::int64_t frame = 0;
+    std::size_t pairNmb = 0;
+    std::size_t contactNmb = 0;
+    for (auto _ : state)
+    {
+        if (++frame % FRAMES_PER_RESET == 0)
+        {
+            state.PauseTiming();
+            scene.Reset();
+            state.ResumeTiming();
+        }
+        physicsManager.FixedUpdate(sf::seconds(game::FIXED_PERIOD));
+        pairNmb += physicsManager.GetCollisionPairs().size();
+        contactNmb += physicsManager.GetContacts().size();
+        benchmark::ClobberMemory();
+    }
+    state.counters["bodies"] = benchmark::Counter(
+        static_cast<double>(state.range(0) + state.range(1)) * static_cast<double>(state.iterations()), benchmark::Counter::kIsRate);
+    state.counters["pairs"] = benchmark::Counter(static_cast<double>(pairNmb), benchmark::Counter::kAvgIterations);
+    state.counters["contacts"] = benchmark::Counter(static_cast<double>(contactNmb), benchmark::Counter::kAvgIterations);
+}
+BENCHMARK(BM_PhysicsFixedUpdate)
+    ->ArgNames({ "players", "bullets", "threads" })
+    ->ArgsProduct({ { 2, 64 }, { 256, 1024, 4096 }, { 1, 4 } })
+    ->Unit(benchmark::kMicrosecond);
+
+/**
+ * \brief BM_PhysicsSubSteps measures the cost of the integration sub-steps: each iteration simulates the same FRAMES_PER_RESET fixed updates
+ * of one fixed period from the initial scene, with all the bodies integrated in subSteps sub-steps.
+ * The frameTime counter gives the time of one fixed update, the pairs counter the candidate pairs per fixed update.
+ * Lowering the tick rate by subSteps pays off when a frame with subSteps sub-steps costs less than subSteps frames with one.
+ */
+static void BM_PhysicsSubSteps(benchmark::State& state)
+{
+    game::PhysicsScene scene(game::MAX_PLAYER_NMB, state.range(0));
+    auto& physicsManager = scene.GetPhysicsManager();
+    const auto subStepCount = static_cast<std::uint32_t>(state.range(1));
+    for (std::size_t bodyClass = 0; bodyClass < static_cast<std::size_t>(game::BodyClass::LENGTH); bodyClass++)
+    {
+        physicsManager.SetSubStepCount(static_cast<game::BodyClass>(bodyClass), subStepCount);
+    }
+    std::size_t pairNmb = 0;
+    for (auto _ : state)
+    {
+        state.PauseTiming();
+        scene.Reset();
+        state.ResumeTiming();
+        for (std::int64_t frame = 0; frame < FRAMES_PER_RESET; frame++)
+        {
+            physicsManager.FixedUpdate(sf::seconds(game::FIXED_PERIOD));
+            pairNmb += physicsManager.GetCollisionPairs().size();
+        }
+        benchmark::ClobberMemory();
+    }
+    const auto frameNmb = static_cast<double>(FRAMES_PER_RESET) * static_cast<double>(state.iterations());
+    state.counters["frameTime"] = benchmark::Counter(frameNmb, benchmark::Counter::kIsRate | benchmark::Counter::kInvert);
+    state.counters["pairs"] = benchmark::Counter(static_cast<double>(pairNmb) / frameNmb);
+}
+BENCHMARK(BM_PhysicsSubSteps)
+    ->ArgNames({ "bullets", "subSteps" })
+    ->ArgsProduct({ { 256, 1024 }, { 1, 2, 4 } })
+    ->Unit(benchmark::kMillisecond);
+
+BENCHMARK_MAIN();
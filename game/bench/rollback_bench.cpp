@@ -0,0 +1,148 @@
+#include <benchmark/benchmark.h>
+#include <spdlog/spdlog.h>
+
+#include "game/game_manager.h"
+
+#include <memory>
+
+namespace
+{
+constexpr std::int64_t MAX_DEPTH = static_cast<std::int64_t>(game::WINDOW_BUFFER_SIZE);
+
+/**
+ * \brief BenchInput gives a deterministic input pattern for a player at a given frame (walking left and right, jumping sometimes).
+ */
+game::PlayerInput BenchInput(game::PlayerNumber playerNumber, game::Frame frame)
+{
+    game::PlayerInput input = (frame / 25u + playerNumber) % 2u ?
+        game::PlayerInputEnum::RIGHT : game::PlayerInputEnum::LEFT;
+    if (frame % 60u == 0u)
+    {
+        input |= game::PlayerInputEnum::UP;
+    }
+    return input;
+}
+
+/**
+ * \brief SetupWorld spawns all the players and bulletNmb validated bullets,
+ * then advances the game by depth frames with all the inputs received but not validated.
+ */
+void SetupWorld(game::HeadlessGameManager& gameManager, game::Frame depth, std::int64_t bulletNmb)
+{
+    for (game::PlayerNumber playerNumber = 0; playerNumber < game::MAX_PLAYER_NMB; playerNumber++)
+    {
+        gameManager.SpawnPlayer(playerNumber,
+            game::SPAWN_POSITIONS[playerNumber],
+            game::SPAWN_DIRECTION[playerNumber]);
+    }
+    //Bullets are laid out on a grid in the upper part of the arena and belong to the same player,
+    //so they test collisions against each other without destroying themselves
+    constexpr int columnNmb = 16;
+    for (std::int64_t i = 0; i < bulletNmb; i++)
+    {
+        const core::Vec2f position{
+            game::LEFT_LIMIT + 1.0f + static_cast<float>(i % columnNmb) * (game::RIGHT_LIMIT - game::LEFT_LIMIT - 2.0f) / columnNmb,
+            game::UPPER_LIMIT - 1.0f - static_cast<float>(i / columnNmb % 8) };
+        gameManager.SpawnValidatedBullet(0, position, core::Vec2f::zero());
+    }
+    for (game::Frame frame = 1; frame <= depth; frame++)
+    {
+        gameManager.AdvanceFrame();
+        for (game::PlayerNumber playerNumber = 0; playerNumber < game::MAX_PLAYER_NMB; playerNumber++)
+        {
+            gameManager.SetPlayerInput(playerNumber, BenchInput(playerNumber, frame), frame);
+        }
+    }
+}
+
+void RollbackArguments(benchmark::internal::Benchmark* benchmark)
+{
+    benchmark->ArgNames({ "depth", "bullets" });
+    for (const std::int64_t depth : { std::int64_t{ 1 }, std::int64_t{ 10 }, std::int64_t{ 50 }, std::int64_t{ 100 }, MAX_DEPTH })
+    {
+        for (const std::int64_t bulletNmb : { 0, 16, 64, 256 })
+        {
+            benchmark->Args({ depth, bulletNmb });
+        }
+    }
+}
+}
+
+static void BM_SimulateToCurrentFrame(benchmark::State& state)
+{
+    const auto depth = static_cast<game::Frame>(state.range(0));
+    auto gameManager = std::make_unique<game::HeadlessGameManager>();
+    SetupWorld(*gameManager, depth, state.range(1));
+    auto& rollbackManager = gameManager->GetRollbackManager();
+    for (auto _ : state)
+    {
+        rollbackManager.SimulateToCurrentFrame();
+    }
+    state.counters["resimulatedFrames"] = benchmark::Counter(
+        static_cast<double>(depth) * static_cast<double>(state.iterations()), benchmark::Counter::kIsRate);
+}
+BENCHMARK(BM_SimulateToCurrentFrame)->Apply(RollbackArguments);
+
+static void BM_ValidateFrame(benchmark::State& state)
+{
+    const auto depth = static_cast<game::Frame>(state.range(0));
+    for (auto _ : state)
+    {
+        state.PauseTiming();
+        auto gameManager = std::make_unique<game::HeadlessGameManager>();
+        SetupWorld(*gameManager, depth, state.range(1));
+        state.ResumeTiming();
+        gameManager->Validate(depth);
+        benchmark::DoNotOptimize(gameManager->GetRollbackManager().GetValidatePhysicsState(0));
+        state.PauseTiming();
+        gameManager.reset();
+        state.ResumeTiming();
+    }
+    state.counters["validatedFrames"] = benchmark::Counter(
+        static_cast<double>(depth) * static_cast<double>(state.iterations()), benchmark::Counter::kIsRate);
+}
+BENCHMARK(BM_ValidateFrame)->Apply(RollbackArguments);
+
+static void BM_ConfirmFrame(benchmark::State& state)
+{
+    const auto depth = static_cast<game::Frame>(state.range(0));
+    //The server physics states are computed on a twin world, as the server would do
+    std::array<game::PhysicsState, game::MAX_PLAYER_NMB> serverPhysicsStates{};
+    {
+        auto serverGameManager = std::make_unique<game::HeadlessGameManager>();
+        SetupWorld(*serverGameManager, depth, state.range(1));
+        serverGameManager->Validate(depth);
+        for (game::PlayerNumber playerNumber = 0; playerNumber < game::MAX_PLAYER_NMB; playerNumber++)
+        {
+            serverPhysicsStates[playerNumber] = serverGameManager->GetRollbackManager().GetValidatePhysicsState(playerNumber);
+        }
+    }
+    for (auto _ : state)
+    {
+        state.PauseTiming();
+        auto gameManager = std::make_unique<game::HeadlessGameManager>();
+        SetupWorld(*gameManager, depth, state.range(1));
+        state.ResumeTiming();
+        gameManager->GetRollbackManager().ConfirmFrame(depth, serverPhysicsStates);
+        state.PauseTiming();
+        gameManager.reset();
+        state.ResumeTiming();
+    }
+    state.counters["confirmedFrames"] = benchmark::Counter(
+        static_cast<double>(depth) * static_cast<double>(state.iterations()), benchmark::Counter::kIsRate);
+}
+BENCHMARK(BM_ConfirmFrame)->Apply(RollbackArguments);
+
+int main(int argc, char** argv)
+{
+    //Spawning logs would be mixed with the benchmark results
+    spdlog::set_level(spdlog::level::warn);
+    benchmark::Initialize(&argc, argv);
+    if (benchmark::ReportUnrecognizedArguments(argc, argv))
+    {
+        return 1;
+    }
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+    return 0;
+}
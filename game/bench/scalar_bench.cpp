@@ -0,0 +1,143 @@
+#include <benchmark/benchmark.h>
+
+#include "bench_scene.h"
+#include "maths/fixed.h"
+
+#include <vector>
+
+namespace
+{
+/**
+ * \brief Body is the part of a game::Rigidbody and game::CircleCollider used by the physics kernel, for a scalar type.
+ */
+template<typename T, typename V>
+struct Body
+{
+    V position;
+    V velocity;
+    T radius;
+};
+
+/**
+ * \brief Vec2Traits gives the scalar type of a vector type.
+ */
+template<typename V>
+struct Vec2Traits;
+template<>
+struct Vec2Traits<core::Vec2f>
+{
+    using Scalar = float;
+};
+template<>
+struct Vec2Traits<core::Vec2Fixed>
+{
+    using Scalar = core::Fixed;
+};
+
+template<typename V>
+std::vector<Body<typename Vec2Traits<V>::Scalar, V>> CreateBodies(std::int64_t bodyNmb)
+{
+    using T = typename Vec2Traits<V>::Scalar;
+    //Both scalar types start from the same float values, so that they simulate the same scene
+    game::ArenaScatter scatter;
+    std::vector<Body<T, V>> bodies(static_cast<std::size_t>(bodyNmb));
+    for (auto& body : bodies)
+    {
+        body.position = V(scatter.NextPosition());
+        const float velocityX = scatter.NextRange(-5.0f, 5.0f);
+        const float velocityY = scatter.NextRange(-5.0f, 5.0f);
+        body.velocity = V(core::Vec2f(velocityX, velocityY));
+        body.radius = T(scatter.NextRange(0.1f, 0.5f));
+    }
+    return bodies;
+}
+
+/**
+ * \brief PhysicsStep is the same work as the game PhysicsManager::FixedUpdate:
+ * gravity integration, clamping in the arena and circle overlaps pushed apart along their normalized distance.
+ */
+template<typename T, typename V>
+void PhysicsStep(std::vector<Body<T, V>>& bodies)
+{
+    const T dt = game::FIXED_PERIOD;
+    const T gravity = game::GRAVITY;
+    const T lowerLimit = game::LOWER_LIMIT;
+    const T upperLimit = game::UPPER_LIMIT;
+    const T leftLimit = game::LEFT_LIMIT;
+    const T rightLimit = game::RIGHT_LIMIT;
+    for (auto& body : bodies)
+    {
+        body.velocity.y += gravity * dt;
+        body.position += body.velocity * dt;
+        if (body.position.y < lowerLimit)
+        {
+            body.position.y = lowerLimit;
+            body.velocity.y = -body.velocity.y;
+        }
+        if (body.position.y > upperLimit)
+        {
+            body.position.y = upperLimit;
+        }
+        if (body.position.x < leftLimit || body.position.x > rightLimit)
+        {
+            body.position.x = body.position.x < leftLimit ? leftLimit : rightLimit;
+            body.velocity.x = -body.velocity.x;
+        }
+    }
+    const T half = 0.5f;
+    for (std::size_t i = 0; i < bodies.size(); i++)
+    {
+        for (std::size_t j = i + 1; j < bodies.size(); j++)
+        {
+            const V distance = bodies[j].position - bodies[i].position;
+            const T radiusSum = bodies[i].radius + bodies[j].radius;
+            if (distance.GetSqrMagnitude() > radiusSum * radiusSum)
+            {
+                continue;
+            }
+            const V mtv = distance.GetNormalized() * (radiusSum - distance.GetMagnitude());
+            bodies[i].position -= mtv * half;
+            bodies[j].position += mtv * half;
+        }
+    }
+}
+
+template<typename V>
+void BM_PhysicsStep(benchmark::State& state)
+{
+    auto bodies = CreateBodies<V>(state.range(0));
+    for (auto _ : state)
+    {
+        PhysicsStep(bodies);
+        benchmark::DoNotOptimize(bodies.data());
+        benchmark::ClobberMemory();
+    }
+    state.counters["bodies"] = benchmark::Counter(
+        static_cast<double>(state.range(0)) * static_cast<double>(state.iterations()), benchmark::Counter::kIsRate);
+}
+
+template<typename V>
+void BM_Normalize(benchmark::State& state)
+{
+    const auto bodies = CreateBodies<V>(state.range(0));
+    std::vector<V> normalized(bodies.size());
+    for (auto _ : state)
+    {
+        for (std::size_t i = 0; i < bodies.size(); i++)
+        {
+            normalized[i] = bodies[i].velocity.GetNormalized();
+        }
+        benchmark::DoNotOptimize(normalized.data());
+        benchmark::ClobberMemory();
+    }
+    state.counters["vectors"] = benchmark::Counter(
+        static_cast<double>(state.range(0)) * static_cast<double>(state.iterations()), benchmark::Counter::kIsRate);
+}
+}
+
+BENCHMARK_TEMPLATE(BM_PhysicsStep, core::Vec2f)->RangeMultiplier(4)->Range(16, 1024);
+BENCHMARK_TEMPLATE(BM_PhysicsStep, core::Vec2Fixed)->RangeMultiplier(4)->Range(16, 1024);
+BENCHMARK_TEMPLATE(BM_Normalize, core::Vec2f)->Range(64, 4096);
+BENCHMARK_TEMPLATE(BM_Normalize, core::Vec2Fixed)->Range(64, 4096);
+
+BENCHMARK_MAIN();
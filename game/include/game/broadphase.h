@@ -0,0 +1,161 @@
+#pragma once
+#include "game_globals.h"
+#include "engine/entity.h"
+#include "maths/scalar.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <span>
+#include <vector>
+
+namespace game
+{
+/**
+ * \brief CollisionFilter selects the colliders that can touch a collider, before any overlap test.
+ * Two colliders are paired if the category of each one is in the mask of the other, and if they do not have the same owner.
+ */
+struct CollisionFilter
+{
+    static constexpr std::uint16_t ALL_CATEGORIES = std::numeric_limits<std::uint16_t>::max();
+    static constexpr std::uint32_t NO_OWNER = std::numeric_limits<std::uint32_t>::max();
+
+    std::uint16_t category = 1u;
+    std::uint16_t mask = ALL_CATEGORIES;
+    std::uint32_t owner = NO_OWNER;
+
+    [[nodiscard]] constexpr bool CanCollide(const CollisionFilter& other) const
+    {
+        return (category & other.mask) != 0 && (other.category & mask) != 0 &&
+            (owner == NO_OWNER || owner != other.owner);
+    }
+};
+
+/**
+ * \brief BroadphaseBody is the bounding circle of a collider given to a broadphase, at the end of the frame.
+ */
+struct BroadphaseBody
+{
+    core::Entity entity = core::INVALID_ENTITY;
+    core::Vec2s position{};
+    core::Scalar radius = 0.0f;
+    /**
+     * \brief displacement is the movement of a continuous collider during the frame, zero for a discrete one.
+     * The bounds of the collider cover its whole sweep.
+     */
+    core::Vec2s displacement{};
+    CollisionFilter filter{};
+
+    [[nodiscard]] core::Vec2s GetMinBound() const
+    {
+        const core::Vec2s start = position - displacement;
+        return { std::min(position.x, start.x) - radius, std::min(position.y, start.y) - radius };
+    }
+    [[nodiscard]] core::Vec2s GetMaxBound() const
+    {
+        const core::Vec2s start = position - displacement;
+        return { std::max(position.x, start.x) + radius, std::max(position.y, start.y) + radius };
+    }
+};
+
+/**
+ * \brief CollisionPair is a candidate pair of colliders found by a broadphase, with entity1 < entity2.
+ * body1 and body2 are the indices of the colliders in the bodies given to the broadphase.
+ */
+struct CollisionPair
+{
+    core::Entity entity1 = core::INVALID_ENTITY;
+    core::Entity entity2 = core::INVALID_ENTITY;
+    std::uint32_t body1 = 0;
+    std::uint32_t body2 = 0;
+
+    constexpr auto operator<=>(const CollisionPair&) const = default;
+};
+
+/**
+ * \brief UniformGridBroadphase is a broadphase that buckets the colliders bounding boxes in a uniform grid covering the arena.
+ * The colliders outside of the arena are put in the border cells, so that no pair is missed.
+ * Only colliders sharing a cell are candidate pairs, so the cost grows linearly with the number of colliders spread in the arena.
+ */
+class UniformGridBroadphase
+{
+public:
+    static constexpr float CELL_SIZE = COLLISION_CELL_SIZE;
+    static constexpr int COLUMN_NMB = static_cast<int>((RIGHT_LIMIT - LEFT_LIMIT) / CELL_SIZE + 0.999f);
+    static constexpr int ROW_NMB = static_cast<int>((UPPER_LIMIT - LOWER_LIMIT) / CELL_SIZE + 0.999f);
+    static constexpr int CELL_NMB = COLUMN_NMB * ROW_NMB;
+
+    /**
+     * \brief FindPairs is a method that gives the candidate pairs of overlapping bounding boxes.
+     * The pairs are sorted by entity1 then entity2, the same order as a double loop over the entities,
+     * so that the collisions are solved in a deterministic order whatever the positions.
+     * \param bodies are the colliders, sorted by entity
+     * \param pairs is cleared and filled with the candidate pairs
+     */
+    void FindPairs(std::span<const BroadphaseBody> bodies, std::vector<CollisionPair>& pairs);
+
+private:
+    struct CellRange
+    {
+        int minColumn = 0;
+        int maxColumn = 0;
+        int minRow = 0;
+        int maxRow = 0;
+    };
+    [[nodiscard]] static CellRange GetCellRange(core::Vec2s minBound, core::Vec2s maxBound);
+
+    std::vector<CellRange> bodyRanges_;
+    std::vector<core::Vec2s> minBounds_;
+    std::vector<core::Vec2s> maxBounds_;
+    /**
+     * \brief cellStarts_ is the index of the first body index of each cell in cellBodies_, filled with a counting sort
+     */
+    std::vector<std::uint32_t> cellStarts_;
+    std::vector<std::uint32_t> cellBodies_;
+};
+
+/**
+ * \brief SweepAndPruneBroadphase is a broadphase that sorts the colliders on the x axis and sweeps them,
+ * only the colliders whose x intervals overlap are tested on the y axis.
+ * The order of the previous call is kept and sorted again with an insertion sort, which is close to linear
+ * when the colliders moved a little since the last frame. Ties are sorted by entity, so the order only depends on
+ * the current colliders and is the same after a rollback, without being part of the rollback state.
+ */
+class SweepAndPruneBroadphase
+{
+public:
+    /**
+     * \brief FindPairs is a method that gives the candidate pairs of overlapping bounding boxes, sorted like UniformGridBroadphase::FindPairs.
+     * \param bodies are the colliders, sorted by entity
+     * \param pairs is cleared and filled with the candidate pairs
+     */
+    void FindPairs(std::span<const BroadphaseBody> bodies, std::vector<CollisionPair>& pairs);
+    /**
+     * \brief GetLastSwapCount is a method that gives the number of swaps done by the last insertion sort, a measure of the order changes.
+     */
+    [[nodiscard]] std::size_t GetLastSwapCount() const { return lastSwapCount_; }
+
+private:
+    struct SweepEntry
+    {
+        core::Scalar minX = 0.0f;
+        core::Scalar maxX = 0.0f;
+        core::Scalar minY = 0.0f;
+        core::Scalar maxY = 0.0f;
+        core::Entity entity = core::INVALID_ENTITY;
+        std::uint32_t body = 0;
+    };
+    static constexpr std::uint32_t INVALID_BODY = std::numeric_limits<std::uint32_t>::max();
+
+    std::vector<SweepEntry> entries_;
+    /**
+     * \brief order_ is the sorted entities of the previous call
+     */
+    std::vector<core::Entity> order_;
+    /**
+     * \brief entityBodies_ is the body index of an entity in the current call, indexed by entity
+     */
+    std::vector<std::uint32_t> entityBodies_;
+    std::size_t lastSwapCount_ = 0;
+};
+}
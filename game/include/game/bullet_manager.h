@@ -2,6 +2,7 @@
 #include <SFML/System/Time.hpp>
 
 #include "game_globals.h"
+#include "maths/scalar.h"
 
 namespace game
 {
@@ -11,9 +12,9 @@ namespace game
 struct Bullet
 {
     PlayerNumber playerNumber = INVALID_PLAYER;
-	float remainingTime = 0.0f;
+	core::Scalar remainingTime = 0.0f;
     
-    float power = 0.0f;
+    core::Scalar power = 0.0f;
 };
 
 class GameManager;
@@ -5,6 +5,7 @@
 #pragma once
 #include <SFML/Graphics/Color.hpp>
 #include <array>
+#include <string_view>
 
 #include "engine/component.h"
 #include "engine/entity.h"
@@ -74,6 +75,31 @@ namespace game
     constexpr float RIGHT_LIMIT = 10.0f;
     constexpr float LOWER_LIMIT = -7.0f;
     constexpr float LEFT_LIMIT = -10.0f;
+    /**
+     * @brief The size of the cells of the collision broadphase grid covering the arena limits
+    */
+    constexpr float COLLISION_CELL_SIZE = 2.0f;
+    /**
+     * @brief The speed under which a dynamic body that is not accelerated is resting
+    */
+    constexpr float SLEEP_VELOCITY = 0.05f;
+    /**
+     * @brief The number of frames a body must rest before it sleeps, sleeping bodies are not integrated until woken up
+    */
+    constexpr std::uint32_t SLEEP_FRAME_NMB = 25;
+    /**
+     * @brief The minimum vertical component of the normal of a level contact for a body to stand on it
+    */
+    constexpr float GROUND_NORMAL_Y = 0.7f;
+    /**
+     * @brief The collision categories of the colliders, the colliders of a player and of its bullets have the player number as owner
+    */
+    constexpr std::uint16_t PLAYER_COLLISION_CATEGORY = 1u << 0u;
+    constexpr std::uint16_t BULLET_COLLISION_CATEGORY = 1u << 1u;
+    /**
+     * @brief The level file loaded by the GameManager, its colliders are added to the arena limits
+    */
+    constexpr std::string_view LEVEL_PATH = "data/levels/arena.txt";
 
 	constexpr core::Vec2f HEALTH_BAR_SCALE{ 4.0f, 0.5f };
     constexpr core::Vec2f PLAYER_SCALE{ 5.0f,5.0f };
@@ -86,6 +112,16 @@ namespace game
  */
 constexpr std::size_t WINDOW_BUFFER_SIZE = 5u * 50u;
 
+/**
+ * \brief MAX_SYNC_TEST_DEPTH is the maximum rollback depth of the client sync test, the rest of the inputs window is kept for the network delay.
+ */
+constexpr std::size_t MAX_SYNC_TEST_DEPTH = WINDOW_BUFFER_SIZE / 2;
+
+/**
+ * \brief RANDOM_SEED is the seed of the rollback random generator used by the simulation
+ */
+constexpr std::uint64_t RANDOM_SEED = 0x5EED5EEDu;
+
 /**
  * \brief startDelay is the delay to wait before starting a game in milliseconds
  */
@@ -13,9 +13,12 @@
 #include "engine/transform.h"
 #include "graphics/graphics.h"
 #include "graphics/sprite.h"
+#include "level.h"
 #include "network/packet_type.h"
+#include "replay.h"
 #include "rollback_manager.h"
 #include "sound_manager.h"
+#include "utils/serialization.h"
 
 namespace game
 {
@@ -36,7 +39,7 @@ public:
      * @param direction The direction the player will be looking at when spawning
     */
     virtual void SpawnPlayer(PlayerNumber playerNumber, core::Vec2f position, core::Vec2f direction);
-    virtual core::Entity SpawnBullet(PlayerNumber, core::Vec2f position, core::Vec2f velocity);
+    virtual core::Entity SpawnBullet(PlayerNumber, core::Vec2s position, core::Vec2s velocity);
     virtual void DestroyBullet(core::Entity entity);
     [[nodiscard]] core::Entity GetEntityFromPlayerNumber(PlayerNumber playerNumber) const;
     [[nodiscard]] Frame GetCurrentFrame() const { return currentFrame_; }
@@ -50,15 +53,91 @@ public:
     void Validate(Frame newValidateFrame);
     [[nodiscard]] PlayerNumber CheckWinner() const;
     virtual void WinGame(PlayerNumber winner);
+    /**
+     * \brief WriteWorld is a method that serializes the whole world (entities, transforms and rollback state) in versioned binary blocks.
+     */
+    void WriteWorld(core::BinaryWriter& writer) const;
+    /**
+     * \brief SaveWorld is a method that serializes the world in a new binary buffer.
+     */
+    [[nodiscard]] std::vector<std::byte> SaveWorld() const;
+    bool SaveWorldToFile(std::string_view path) const;
+    /**
+     * \brief LoadWorld is a method that restores the world from a serialized world, read in place from the view.
+     * Only the simulation state is restored, not the graphics of the ClientGameManager.
+     * \return false if the world is invalid, in this case the current world is kept
+     */
+    bool LoadWorld(const core::BinaryView& view);
+    bool LoadWorld(std::span<const std::byte> buffer);
+    /**
+     * \brief LoadWorldFromFile is a method that maps a serialized world file and restores it without an intermediate copy.
+     */
+    bool LoadWorldFromFile(std::string_view path);
+    /**
+     * \brief StartRecording is a method that starts recording the spawns and the validated inputs in a replay.
+     * The recording must start before the first frame is validated.
+     * \param path is the replay file, written when the recording stops
+     * \return false if frames were already validated
+     */
+    bool StartRecording(std::string_view path);
+    /**
+     * \brief StopRecording is a method that stops the recording and writes the replay file.
+     * It is called automatically when the game is won.
+     */
+    bool StopRecording();
+    [[nodiscard]] bool IsRecording() const { return replayRecorder_.IsRecording(); }
+    [[nodiscard]] ReplayRecorder& GetReplayRecorder() { return replayRecorder_; }
+    /**
+     * \brief LoadLevel is a method that loads the static level geometry used by the simulation, LEVEL_PATH is loaded at construction.
+     * All the peers of a game must use the same level, it must not change once the game started.
+     * \return false if the level file could not be read, in this case only the arena limits are kept.
+     * The level is part of the world hash and of the replays, so a peer or a replay using another level is detected.
+     */
+    bool LoadLevel(std::string_view path);
+    [[nodiscard]] const Level& GetLevel() const { return level_; }
 
 
 protected:
     core::EntityManager entityManager_;
     core::TransformManager transformManager_;
+    Level level_;
     RollbackManager rollbackManager_;
     std::array<core::Entity, MAX_PLAYER_NMB> playerEntityMap_{};
     Frame currentFrame_ = 0;
     PlayerNumber winner_ = INVALID_PLAYER;
+    std::array<ReplaySpawn, MAX_PLAYER_NMB> playerSpawns_{};
+    ReplayRecorder replayRecorder_;
+    std::string replayPath_;
+};
+
+/**
+ * \brief HeadlessGameManager is a GameManager without rendering nor networking that advances its own frames.
+ * It is used by benchmarks and offline tools to drive the rollback simulation directly.
+ */
+class HeadlessGameManager : public GameManager
+{
+public:
+    /**
+     * \brief AdvanceFrame is a method that increments the current frame of the game and of the rollback manager.
+     */
+    void AdvanceFrame();
+    /**
+     * \brief SpawnValidatedBullet is a method that spawns a bullet directly in the current and last validated state,
+     * so that it survives rollbacks. It is used to populate a world before the simulation starts.
+     * \return the bullet entity
+     */
+    core::Entity SpawnValidatedBullet(PlayerNumber playerNumber, core::Vec2f position, core::Vec2f velocity);
+    /**
+     * \brief StartReplay is a method that restores the starting world of a replay (random generator and players).
+     * It must be called on a new HeadlessGameManager, the inputs of the replay are then set frame by frame.
+     * \return false if the replay was recorded with another level
+     */
+    bool StartReplay(const ReplayReader& replay);
+    /**
+     * \brief LoadKeyframe is a method that restores a serialized world and rewinds it to its last validated frame.
+     * \return false if the world is invalid
+     */
+    bool LoadKeyframe(std::span<const std::byte> world);
 };
 
 /**
@@ -117,7 +196,7 @@ public:
      * @param velocity The velocity to give to a bullet
      * @return Entity (bullet)
     */
-    core::Entity SpawnBullet(PlayerNumber playerNumber, core::Vec2f position, core::Vec2f velocity) override;
+    core::Entity SpawnBullet(PlayerNumber playerNumber, core::Vec2s position, core::Vec2s velocity) override;
     /**
      * @brief Creates a Healthbar for a player
      * @param playerNumber The player number for which we want to create a Healthbar
@@ -144,6 +223,12 @@ public:
      * @param physicsStates the physics state given for check and validation
     */
     void ConfirmValidateFrame(Frame newValidateFrame, const std::array<PhysicsState, MAX_PLAYER_NMB>& physicsStates);
+    /**
+     * @brief Enables the sync test mode, where the validated frames are confirmed syncTestDepth frames late,
+     * so that every fixed frame rolls back and resimulates at least syncTestDepth frames and compares them to their first simulation
+     * @param syncTestDepth The rollback depth, 0 disables the sync test
+    */
+    void SetSyncTestDepth(Frame syncTestDepth);
     [[nodiscard]] PlayerNumber GetPlayerNumber() const { return clientPlayer_; }
     /**
      * @brief Method used to declare when the game has been won
@@ -164,6 +249,18 @@ protected:
      * @brief Instantiates the background elements
     */
     void CreateBackground();
+    /**
+     * @brief Instantiates the sprites of the level colliders
+    */
+    void CreateLevel();
+    /**
+     * @brief Validates a frame received from the server and checks its physics states
+    */
+    void ApplyValidateFrame(Frame newValidateFrame, const std::array<PhysicsState, MAX_PLAYER_NMB>& physicsStates);
+    /**
+     * @brief Confirms the validate frames received from the server that are at least the sync test depth behind the current frame
+    */
+    void ConfirmPendingFrames();
 
     PacketSenderInterface& packetSenderInterface_;
     sf::Vector2u windowSize_;
@@ -188,5 +285,15 @@ protected:
     sf::Text textRenderer_;
 
 	bool drawPhysics_ = false;
+
+    /**
+     * @brief PendingValidateFrame is a validate frame received from the server and delayed by the sync test
+    */
+    struct PendingValidateFrame
+    {
+        Frame validateFrame = 0;
+        std::array<PhysicsState, MAX_PLAYER_NMB> physicsStates{};
+    };
+    std::vector<PendingValidateFrame> pendingValidateFrames_;
 };
 }
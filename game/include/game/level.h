@@ -0,0 +1,169 @@
+/**
+ * \file level.h
+ */
+#pragma once
+#include "maths/scalar.h"
+
+#include <array>
+#include <cstdint>
+#include <span>
+#include <string_view>
+#include <vector>
+
+namespace game
+{
+/**
+ * \brief Aabb is an axis-aligned bounding box in meters.
+ */
+struct Aabb
+{
+    core::Vec2s min{};
+    core::Vec2s max{};
+
+    [[nodiscard]] bool Overlaps(const Aabb& other) const
+    {
+        return !(max.x < other.min.x || other.max.x < min.x || max.y < other.min.y || other.max.y < min.y);
+    }
+};
+
+enum class LevelShape : std::uint32_t
+{
+    BOX,
+    SEGMENT
+};
+
+/**
+ * \brief LevelCollider is a static collider of the level geometry.
+ * A BOX goes from point1, its minimum corner, to point2, its maximum corner, a SEGMENT goes from point1 to point2.
+ */
+struct LevelCollider
+{
+    LevelShape shape = LevelShape::BOX;
+    core::Vec2s point1{};
+    core::Vec2s point2{};
+
+    [[nodiscard]] Aabb GetBounds() const;
+    /**
+     * \brief FindContact is a method that tests a circle against the collider.
+     * \param normal is set to the direction pushing the circle out of the collider
+     * \param depth is set to the distance the circle must be pushed along the normal
+     * \return true if the circle overlaps the collider
+     */
+    bool FindContact(core::Vec2s center, core::Scalar radius, core::Vec2s& normal, core::Scalar& depth) const;
+};
+
+/**
+ * \brief StaticBvh is a bounding volume hierarchy over static bounds, built once and only queried afterwards.
+ * The nodes are stored depth first, the left child of a node follows it and the right child index is stored in the node.
+ * The build sorts the bounds with a total order, so that the tree and the order of the queries are the same on every client.
+ */
+class StaticBvh
+{
+public:
+    static constexpr std::size_t LEAF_SIZE = 4;
+    static constexpr std::size_t MAX_DEPTH = 64;
+
+    void Build(std::span<const Aabb> bounds);
+    /**
+     * \brief Query is a method that calls visitor with the index of each bounds overlapping the given bounds.
+     */
+    template<typename Visitor>
+    void Query(const Aabb& bounds, Visitor&& visitor) const
+    {
+        if (nodes_.empty())
+        {
+            return;
+        }
+        std::array<std::uint32_t, MAX_DEPTH> stack{};
+        std::size_t stackSize = 0;
+        stack[stackSize++] = 0;
+        while (stackSize > 0)
+        {
+            const auto& node = nodes_[stack[--stackSize]];
+            if (!node.bounds.Overlaps(bounds))
+            {
+                continue;
+            }
+            if (node.count > 0)
+            {
+                for (auto i = node.first; i < node.first + node.count; i++)
+                {
+                    if (bounds_[indices_[i]].Overlaps(bounds))
+                    {
+                        visitor(indices_[i]);
+                    }
+                }
+                continue;
+            }
+            //The left child is visited first
+            const auto nodeIndex = static_cast<std::uint32_t>(&node - nodes_.data());
+            stack[stackSize++] = node.first;
+            stack[stackSize++] = nodeIndex + 1;
+        }
+    }
+    [[nodiscard]] std::size_t GetNodeCount() const { return nodes_.size(); }
+
+private:
+    /**
+     * \brief Node is a leaf when count is not zero, its bounds are indices_[first, first + count),
+     * otherwise first is the index of its right child.
+     */
+    struct Node
+    {
+        Aabb bounds{};
+        std::uint32_t first = 0;
+        std::uint32_t count = 0;
+    };
+    void BuildNode(std::uint32_t first, std::uint32_t count, std::size_t depth);
+
+    std::vector<Aabb> bounds_;
+    std::vector<std::uint32_t> indices_;
+    std::vector<Node> nodes_;
+};
+
+/**
+ * \brief Level is the static geometry of the arena, loaded from a level file, with the hierarchy used to query it.
+ * It is never modified by the simulation, so it is shared by the current and the validated physics and never rolled back.
+ *
+ * A level file is a text file with one collider per line, in meters, and comments starting with #:
+ * box <minX> <minY> <maxX> <maxY>
+ * segment <x1> <y1> <x2> <y2>
+ */
+class Level
+{
+public:
+    /**
+     * \brief LoadFromFile is a method that replaces the level with the colliders of a level file.
+     * \return true if the file was read, the level is left empty otherwise
+     */
+    bool LoadFromFile(std::string_view path);
+    /**
+     * \brief LoadFromString is a method that replaces the level with the colliders of the text of a level file.
+     * \return true if the text was parsed, the level is left empty otherwise
+     */
+    bool LoadFromString(std::string_view text);
+    void SetColliders(std::vector<LevelCollider> colliders);
+    [[nodiscard]] std::span<const LevelCollider> GetColliders() const { return colliders_; }
+    [[nodiscard]] const StaticBvh& GetBvh() const { return bvh_; }
+    /**
+     * \brief GetHash is a method that gives the hash of the colliders, so that peers and replays using different levels are detected.
+     */
+    [[nodiscard]] std::uint64_t GetHash() const { return hash_; }
+    /**
+     * \brief Query is a method that calls visitor with each collider whose bounds overlap the given bounds.
+     */
+    template<typename Visitor>
+    void Query(const Aabb& bounds, Visitor&& visitor) const
+    {
+        bvh_.Query(bounds, [this, &visitor](std::uint32_t index)
+        {
+            visitor(colliders_[index]);
+        });
+    }
+
+private:
+    std::vector<LevelCollider> colliders_;
+    StaticBvh bvh_;
+    std::uint64_t hash_ = 0;
+};
+}
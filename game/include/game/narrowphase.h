@@ -0,0 +1,107 @@
+#pragma once
+#include "broadphase.h"
+#include "engine/entity.h"
+#include "maths/scalar.h"
+
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <span>
+#include <thread>
+#include <vector>
+
+namespace game
+{
+/**
+ * \brief Contact is an overlap between two circle colliders found by the narrowphase.
+ * normal goes from entity1 to entity2 and mtv is the translation that separates them, along the normal.
+ * A contact found by the swept test of continuous colliders has the normal at the time of impact and a zero mtv,
+ * as the colliders do not overlap at the end of the frame.
+ */
+struct Contact
+{
+    core::Entity entity1 = core::INVALID_ENTITY;
+    core::Entity entity2 = core::INVALID_ENTITY;
+    core::Vec2s normal{};
+    core::Vec2s mtv{};
+};
+
+/**
+ * \brief CircleNarrowphase is a class that tests the candidate pairs of a broadphase by batches of BATCH_SIZE pairs.
+ * The overlap test of a batch only uses squared distances on fixed size arrays without branches, so that the compiler
+ * vectorizes it, the square root and the normal are only computed for the overlapping pairs.
+ * The pairs that do not overlap at the end of the frame but have a displacement are then tested with their sweeps,
+ * so that fast colliders do not pass through each other between two frames.
+ */
+class CircleNarrowphase
+{
+public:
+    static constexpr std::size_t BATCH_SIZE = 8;
+    /**
+     * \brief FindContacts is a method that gives the overlapping pairs, in the order of the candidate pairs.
+     * \param bodies are the colliders given to the broadphase
+     * \param pairs are the candidate pairs of the broadphase
+     * \param contacts is cleared and filled with the contacts
+     */
+    static void FindContacts(std::span<const BroadphaseBody> bodies,
+        std::span<const CollisionPair> pairs,
+        std::vector<Contact>& contacts);
+private:
+    /**
+     * \brief FindSweptContact is a method that finds the first time two moving circles touch during the frame.
+     * \param contact gets the normal at the time of impact when the sweeps touch
+     * \return true if the circles touch during the frame
+     */
+    static bool FindSweptContact(const BroadphaseBody& body1, const BroadphaseBody& body2, Contact& contact);
+};
+
+/**
+ * \brief ParallelNarrowphase is a class that splits the candidate pairs of a broadphase in contiguous ranges,
+ * tested by CircleNarrowphase on worker threads kept alive between the frames.
+ * Each range fills its own contact list, and the lists are merged in the order of the ranges, so the contacts are
+ * in the order of the candidate pairs, sorted by entities, and bit-identical to a single threaded CircleNarrowphase.
+ */
+class ParallelNarrowphase
+{
+public:
+    /**
+     * \brief MIN_TASK_PAIR_NMB is the minimum number of pairs given to a thread, smaller frames are tested on the calling thread
+     * as waking up the workers costs more than testing the pairs.
+     */
+    static constexpr std::size_t MIN_TASK_PAIR_NMB = 512;
+
+    ParallelNarrowphase() = default;
+    ~ParallelNarrowphase();
+    ParallelNarrowphase(const ParallelNarrowphase&) = delete;
+    ParallelNarrowphase& operator=(const ParallelNarrowphase&) = delete;
+    /**
+     * \brief SetThreadCount is a method that sets the number of threads testing the pairs, including the calling thread.
+     * \param threadCount is the number of threads, 1 or 0 tests all the pairs on the calling thread
+     */
+    void SetThreadCount(std::size_t threadCount);
+    [[nodiscard]] std::size_t GetThreadCount() const { return workers_.size() + 1; }
+    /**
+     * \brief FindContacts is a method that gives the overlapping pairs, in the order of the candidate pairs, like CircleNarrowphase::FindContacts.
+     */
+    void FindContacts(std::span<const BroadphaseBody> bodies,
+        std::span<const CollisionPair> pairs,
+        std::vector<Contact>& contacts);
+private:
+    void StopWorkers();
+    void RunWorker(std::size_t taskIndex);
+    [[nodiscard]] std::span<const CollisionPair> GetTaskPairs(std::size_t taskIndex) const;
+
+    std::vector<std::thread> workers_;
+    std::vector<std::vector<Contact>> taskContacts_;
+    std::mutex mutex_;
+    std::condition_variable startCondition_;
+    std::condition_variable doneCondition_;
+    //The task of a frame, written under the mutex before the generation changes
+    std::span<const BroadphaseBody> bodies_;
+    std::span<const CollisionPair> pairs_;
+    std::size_t taskCount_ = 0;
+    std::size_t pendingTaskCount_ = 0;
+    std::uint64_t generation_ = 0;
+    bool isStopping_ = false;
+};
+}
@@ -1,14 +1,17 @@
 #pragma once
+#include "broadphase.h"
 #include "game_globals.h"
+#include "level.h"
+#include "narrowphase.h"
 #include "engine/component.h"
 #include "engine/entity.h"
-#include "maths/angle.h"
+#include "maths/scalar.h"
 #include "maths/vec2.h"
 
+#include <SFML/Graphics/VertexArray.hpp>
 #include <SFML/System/Time.hpp>
 
 #include "graphics/graphics.h"
-#include "utils/action_utility.h"
 
 namespace core
 {
@@ -24,41 +27,81 @@ enum class BodyType
 };
 
 /**
- * \brief CircleCollider is a circle shape collider used in the physics engine
+ * \brief CollisionDetection is the way the collisions of a body are detected.
+ * A CONTINUOUS body is tested with its sweep during the frame, so that it cannot pass through another collider
+ * when it moves further than their radii in one fixed update.
+ */
+enum class CollisionDetection
+{
+    DISCRETE,
+    CONTINUOUS
+};
+
+/**
+ * \brief BroadphaseType is the broadphase used by the PhysicsManager to find the candidate collision pairs.
+ * Both give the same pairs, SWEEP_AND_PRUNE is faster when the colliders move mostly horizontally.
+ */
+enum class BroadphaseType
+{
+    UNIFORM_GRID,
+    SWEEP_AND_PRUNE
+};
+
+/**
+ * \brief BodyClass is the kind of a simulated body, each class is integrated with its own number of sub-steps per fixed frame.
+ */
+enum class BodyClass : std::uint8_t
+{
+    OTHER,
+    PLAYER,
+    BULLET,
+    LENGTH
+};
+
+[[nodiscard]] constexpr BodyClass GetBodyClass(core::EntityMask entityMask)
+{
+    if (entityMask & static_cast<core::EntityMask>(ComponentType::PLAYER_CHARACTER))
+        return BodyClass::PLAYER;
+    if (entityMask & static_cast<core::EntityMask>(ComponentType::BULLET))
+        return BodyClass::BULLET;
+    return BodyClass::OTHER;
+}
+
+/**
+ * \brief CircleCollider is a circle shape collider used in the physics engine,
+ * filter prunes the pairs that must not collide in the broadphase, so they are never tested nor dispatched.
  */
 struct CircleCollider
 {
-    float radius = 0.5f;
+    core::Scalar radius = 0.5f;
     bool isTrigger = false;
+    CollisionFilter filter{};
 };
 /**
  * \brief Rigidbody is a class that represents a physical body.
+ * Its values are core::Scalar, so that the simulation can run in fixed-point, and its rotations are in degrees.
+ * restFrameNmb counts the frames the body has been resting, it sleeps after SLEEP_FRAME_NMB of them.
+ * isGrounded is set when the body stands on the level geometry.
  */
 struct Rigidbody
 {
-    core::Vec2f position = core::Vec2f::zero();
-    core::Degree rotation = core::Degree(0.0f);
+    core::Vec2s position = core::Vec2s::zero();
+    core::Scalar rotation = 0.0f;
 
-    core::Vec2f velocity = core::Vec2f::zero();
-    core::Degree angularVelocity = core::Degree(0.0f);
+    core::Vec2s velocity = core::Vec2s::zero();
+    core::Scalar angularVelocity = 0.0f;
 
-	core::Vec2f acceleration = core::Vec2f::zero();
+	core::Vec2s acceleration = core::Vec2s::zero();
 
     BodyType bodyType = BodyType::DYNAMIC;
+    CollisionDetection collisionDetection = CollisionDetection::DISCRETE;
+    std::uint32_t restFrameNmb = 0;
 
-    float bounciness = 1.0f;
-    float gravityScale = 1.0f;
-};
+    core::Scalar bounciness = 1.0f;
+    core::Scalar gravityScale = 1.0f;
+    bool isGrounded = false;
 
-/**
- * \brief OnTriggerInterface is an interface for classes that needs to be called when two boxes are in contact.
- * It needs to be registered in the PhysicsManager.
- */
-class OnTriggerInterface
-{
-public:
-    virtual ~OnTriggerInterface() = default;
-    virtual void OnTrigger(core::Entity entity1, core::Entity entity2) = 0;
+    [[nodiscard]] bool IsSleeping() const { return restFrameNmb >= SLEEP_FRAME_NMB; }
 };
 
 /**
@@ -80,7 +123,7 @@ public:
 
 /**
  * \brief PhysicsManager is a class that holds both RigidbodyManager and CircleManager and manages the physics fixed update.
- * It allows to register OnTriggerInterface to be called when a trigger occcurs.
+ * The contacts found during the fixed update are kept in a contact buffer, consumed after the step by the game logic.
  */
 class PhysicsManager : public core::DrawInterface
 {
@@ -88,19 +131,48 @@ public:
     explicit PhysicsManager(core::EntityManager& entityManager);
 
     /**
-     * @brief Applies gravtity to all Rigidbodies
+     * @brief Integrates the dynamic bodies in a single pass, modified in place: applies the gravity, moves them,
+     * and limits the players' movement to the arena.
+     * The circle colliders are pushed out of the level geometry, querying only the level colliders around them.
+     * The sleeping bodies are skipped, and the bodies resting for SLEEP_FRAME_NMB frames are put to sleep.
+     * Each body is integrated in the sub-steps of its class, pushed out of the level and limited to the arena at each of them.
      * @param dt The delta time used to update
     */
-    void ApplyGravityToRigidbodies(sf::Time dt);
+    void IntegrateRigidbodies(sf::Time dt);
     /**
-     * @brief Method to limit le player's movement to a defined box
-     * @param dt The delta time used to update
+     * @brief Checks for collisions between circle colliders, on the candidate pairs given by the broadphase,
+     * and fills the contact buffer with the contacts of the narrowphase.
+     * The pairs of static or sleeping bodies are not tested, the sleeping bodies touched by an awake one are woken up
+     * @param dt The delta time of the update, giving the sweep of the continuous bodies
+    */
+    void CheckForCircleCollisions(sf::Time dt);
+    /**
+     * @brief Sets the static level geometry the bodies collide with, it must outlive the physics manager
+     * @param level The level, or nullptr for the arena limits only
+    */
+    void SetLevel(const Level* level) { level_ = level; }
+    [[nodiscard]] const Level* GetLevel() const { return level_; }
+    void SetBroadphaseType(BroadphaseType broadphaseType) { broadphaseType_ = broadphaseType; }
+    /**
+     * @brief Sets the number of threads testing the candidate pairs of the narrowphase, including the calling thread.
+     * The contacts are the same whatever the number of threads.
+     * @param threadCount The number of threads, 1 to test the pairs on the calling thread only
     */
-    void LimitPlayerMovement(sf::Time dt);
+    void SetThreadCount(std::size_t threadCount) { narrowphase_.SetThreadCount(threadCount); }
     /**
-     * @brief Checks for collisions between circle colliders
+     * @brief Sets the number of integration sub-steps per fixed update of a class of bodies.
+     * More sub-steps keep the level collisions of fast bodies accurate with a longer fixed period,
+     * the collisions between the bodies are still detected once per fixed update, with the sweeps of the continuous bodies.
+     * All the peers of a game must use the same sub-steps.
+     * @param bodyClass The class of the bodies
+     * @param subStepCount The number of sub-steps, at least 1
     */
-    void CheckForCircleCollisions();
+    void SetSubStepCount(BodyClass bodyClass, std::uint32_t subStepCount);
+    [[nodiscard]] std::uint32_t GetSubStepCount(BodyClass bodyClass) const
+    {
+        return subStepCounts_[static_cast<std::size_t>(bodyClass)];
+    }
+    [[nodiscard]] BroadphaseType GetBroadphaseType() const { return broadphaseType_; }
     /**
      * @brief The physical update
      * @param dt The time used to update
@@ -113,7 +185,7 @@ public:
     */
     void AddRigidbody(core::Entity entity);
     /**
-     * @brief Sets an Entity's rigidboy to the given rigidbody
+     * @brief Sets an Entity's rigidboy to the given rigidbody, a body moved or pushed by the game is woken up
      * @param entity The entity to set
      * @param rigidbody The given rigidbody
     */
@@ -132,19 +204,43 @@ public:
      */
     void SetCircle(core::Entity entity, const CircleCollider& sphere);
     [[nodiscard]] const CircleCollider& GetCircle(core::Entity entity) const;
+    /**
+     * @brief Gives the dynamic bodies integrated by the fixed update, sorted by entity.
+     * The list is kept by AddRigidbody and SetRigidbody, the entities that lost their rigidbody are removed at the next integration.
+    */
+    [[nodiscard]] std::span<const core::Entity> GetDynamicBodies() const { return dynamicBodies_; }
 
     /**
-     * \brief RegisterTriggerListener is a method that stores an OnTriggerInterface in the PhysicsManager that will call the OnTrigger method in case of a trigger.
-     * \param onTriggerInterface is the OnTriggerInterface to be called when a trigger occurs.
+     * \brief GetContacts is a method that gives the contacts found by the last fixed update, sorted by entities.
+     * Each contact has its own MTV, the contacts are computed with the positions before any of them is solved.
      */
-    void RegisterTriggerListener(OnTriggerInterface& onTriggerInterface);
+    [[nodiscard]] std::span<const Contact> GetContacts() const { return contacts_; }
+    /**
+     * \brief GetCollisionPairs is a method that gives the candidate pairs tested by the narrowphase of the last fixed update.
+     */
+    [[nodiscard]] std::span<const CollisionPair> GetCollisionPairs() const { return collisionPairs_; }
     /**
      * @brief Copies all the element of the physics manager
      * @param physicsManager The physics manager to copy from
     */
     void CopyAllComponents(const PhysicsManager& physicsManager);
     /**
-     * @brief Draws the shapes of the physical elements
+     * @brief Gives the size in bytes of all the components arrays, which is the amount copied by CopyAllComponents
+    */
+    [[nodiscard]] std::size_t GetAllComponentsByteSize() const;
+    [[nodiscard]] const std::vector<Rigidbody>& GetAllRigidbodies() const { return rigidbodyManager_.GetAllComponents(); }
+    [[nodiscard]] const std::vector<CircleCollider>& GetAllCircles() const { return circleColliderManager_.GetAllComponents(); }
+    /**
+     * @brief Copies the rigidbodies and circle colliders arrays, for example read from a serialized world
+    */
+    void CopyAllComponents(std::span<const Rigidbody> rigidbodies, std::span<const CircleCollider> circles);
+    /**
+     * @brief Number of segments of the debug circles, like the default point count of a sf::CircleShape
+    */
+    static constexpr std::size_t DEBUG_CIRCLE_SEGMENT_NMB = 30;
+    static constexpr float DEBUG_OUTLINE_THICKNESS = 2.0f;
+    /**
+     * @brief Draws the outlines of the circle colliders, batched in a single vertex array submitted in one draw call
      * @param renderTarget the target to render the shapes on
     */
     void Draw(sf::RenderTarget& renderTarget) override;
@@ -163,22 +259,33 @@ public:
      * @param otherBody The second rigidbody to evaluate
      * @param mtv The minimum translation vector used to set rigidbodies positions
     */
-    static void SolveMTV(Rigidbody& myBody, Rigidbody& otherBody, const core::Vec2f& mtv);
-
-    [[nodiscard]] core::Vec2f GetMTV() const { return mtv_; }
+    static void SolveMTV(Rigidbody& myBody, Rigidbody& otherBody, const core::Vec2s& mtv);
 
 private:
+    void AddDynamicBody(core::Entity entity);
+    void RemoveDynamicBody(core::Entity entity);
+    void ResolveLevelContacts(Rigidbody& rigidbody, core::Scalar radius) const;
 
     core::EntityManager& entityManager_;
     RigidbodyManager rigidbodyManager_;
     CircleColliderManager circleColliderManager_;
-    core::Action<core::Entity, core::Entity> onTriggerAction_;
+    std::vector<core::Entity> dynamicBodies_;
+    const Level* level_ = nullptr;
+    std::array<std::uint32_t, static_cast<std::size_t>(BodyClass::LENGTH)> subStepCounts_{ 1, 1, 1 };
+    BroadphaseType broadphaseType_ = BroadphaseType::UNIFORM_GRID;
+    UniformGridBroadphase uniformGrid_;
+    SweepAndPruneBroadphase sweepAndPrune_;
+    std::vector<BroadphaseBody> broadphaseBodies_;
+    //Whether each broadphase body is dynamic and awake, a pair needs at least one of them to be tested
+    std::vector<std::uint8_t> activeBodies_;
+    std::vector<CollisionPair> collisionPairs_;
+    ParallelNarrowphase narrowphase_;
+    std::vector<Contact> contacts_;
     //Used for debug
+    sf::VertexArray debugVertices_{ sf::Triangles };
     sf::Vector2f center_{};
     sf::Vector2f windowSize_{};
 
-    core::Vec2f mtv_{};
-
 };
 
 }
@@ -2,6 +2,7 @@
 #include <SFML/System/Time.hpp>
 
 #include "game_globals.h"
+#include "maths/scalar.h"
 #include "game/animation_manager.h"
 #include "SFML/Graphics/Sprite.hpp"
 
@@ -15,16 +16,16 @@ struct PlayerCharacter
 {
     PlayerInput input = 0u;
     PlayerNumber playerNumber = INVALID_PLAYER;
-    float health = PLAYER_HEALTH;
-    float shootingTime = 0.0f;
-    float invincibilityTime = 0.0f;
+    core::Scalar health = PLAYER_HEALTH;
+    core::Scalar shootingTime = 0.0f;
+    core::Scalar invincibilityTime = 0.0f;
     bool isGrounded = false;
     bool isShooting = false;
 
-    core::Vec2f lookDir = core::Vec2f::zero();
+    core::Vec2s lookDir = core::Vec2s::zero();
     AnimationState animationState = AnimationState::NONE;
 
-    float bulletPower = 0.0f;
+    core::Scalar bulletPower = 0.0f;
     core::Entity currentBullet = 0;
 };
 class GameManager;
@@ -39,6 +40,13 @@ public:
     void FixedUpdate(sf::Time dt);
 
 private:
+    /**
+     * \brief IsCurrentBulletAlive is a method that checks that the charged bullet of the player still exists.
+     * A destroyed bullet is only flagged until validated, then its entity can be reused by another bullet,
+     * so the bullet must also still belong to the player.
+     */
+    [[nodiscard]] bool IsCurrentBulletAlive(const PlayerCharacter& playerCharacter) const;
+
     PhysicsManager& physicsManager_;
     GameManager& gameManager_;
 };
@@ -0,0 +1,207 @@
+/**
+ * \file replay.h
+ */
+#pragma once
+#include "game_globals.h"
+#include "maths/random.h"
+#include "maths/vec2.h"
+#include "utils/mapped_file.h"
+#include "utils/serialization.h"
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace game
+{
+/**
+ * \brief REPLAY_MAGIC identifies a replay file.
+ */
+constexpr core::BinaryMagic REPLAY_MAGIC{ 'G', 'P', 'R', 'R' };
+/**
+ * \brief REPLAY_VERSION is the version of the replay binary format, it must be increased when a block changes its layout.
+ * The keyframes are serialized worlds, so it is also increased with every WORLD_VERSION.
+ */
+constexpr std::uint32_t REPLAY_VERSION = 7;
+
+/**
+ * \brief ReplayBlock is the identifier of each block of a replay file.
+ * Values must never be reused, new blocks are added at the end.
+ */
+enum class ReplayBlock : std::uint32_t
+{
+    RANDOM = 1,
+    SPAWNS,
+    INPUT_RUNS,
+    VALIDATE_FRAMES,
+    KEYFRAMES,
+    KEYFRAME_INDEX,
+    LEVEL_HASH,
+};
+
+/**
+ * \brief REPLAY_KEYFRAME_INTERVAL is the default minimum number of validated frames between two keyframes of a replay.
+ * Seeking in a replay resimulates at most this number of frames plus one validation batch.
+ */
+constexpr Frame REPLAY_KEYFRAME_INTERVAL = 5u * 50u;
+
+/**
+ * \brief ReplaySpawn is the spawn information of a player, needed to recreate the starting world of a replay.
+ */
+struct ReplaySpawn
+{
+    core::Vec2f position;
+    core::Vec2f direction;
+    std::uint32_t playerNumber = INVALID_PLAYER;
+};
+
+/**
+ * \brief InputRun is a run-length encoded sequence of validated frames where all the players kept the same inputs.
+ */
+struct InputRun
+{
+    std::array<PlayerInput, MAX_PLAYER_NMB> inputs{};
+    std::uint16_t length = 0;
+};
+
+/**
+ * \brief ReplayKeyframe is an entry of the keyframe index, written at the end of a replay.
+ * It locates a serialized world (see GameManager::SaveWorld) saved just after the frame was validated.
+ */
+struct ReplayKeyframe
+{
+    Frame frame = 0;
+    std::uint32_t reserved = 0;
+    /**
+     * \brief offset is the offset of the serialized world from the start of the replay file, aligned on core::BINARY_ALIGNMENT.
+     */
+    std::uint64_t offset = 0;
+    std::uint64_t size = 0;
+};
+
+/**
+ * \brief ReplayRecorder is a class that records the spawn information and the validated inputs of a game, starting from frame 1.
+ * As the simulation is deterministic, this is enough to simulate the whole game again.
+ * The validated frames are recorded too, as the entities destroyed in a validation free their index for the next one,
+ * and the order of the entities changes the order of the collisions.
+ */
+class ReplayRecorder
+{
+public:
+    /**
+     * \brief Start is a method that clears the previous recording and starts a new one.
+     * \param random is the state of the rollback random generator at the start of the game
+     * \param levelHash is the hash of the level of the game, see Level::GetHash
+     */
+    void Start(const core::Pcg32& random, std::uint64_t levelHash);
+    /**
+     * \brief Stop is a method that stops recording, the recorded game is kept until the next Start.
+     */
+    void Stop() { isRecording_ = false; }
+    [[nodiscard]] bool IsRecording() const { return isRecording_; }
+    void RecordSpawn(PlayerNumber playerNumber, core::Vec2f position, core::Vec2f direction);
+    /**
+     * \brief RecordFrame is a method called for each newly validated frame, in order.
+     * \param frame is the validated frame, it must follow the last recorded one
+     * \param inputs is the validated input of each player at this frame
+     */
+    void RecordFrame(Frame frame, const std::array<PlayerInput, MAX_PLAYER_NMB>& inputs);
+    /**
+     * \brief RecordValidation is a method called at the end of each validation, with the new last validated frame.
+     */
+    void RecordValidation(Frame validateFrame);
+    /**
+     * \brief IsKeyframeNeeded is a method that checks if a keyframe should be recorded for a newly validated frame.
+     */
+    [[nodiscard]] bool IsKeyframeNeeded(Frame validateFrame) const;
+    /**
+     * \brief RecordKeyframe is a method that stores a serialized world of the last validated frame, used to seek in the replay.
+     */
+    void RecordKeyframe(Frame validateFrame, std::span<const std::byte> world);
+    void SetKeyframeInterval(Frame keyframeInterval) { keyframeInterval_ = std::max(keyframeInterval, Frame{ 1 }); }
+    [[nodiscard]] Frame GetFrameCount() const { return frameCount_; }
+    [[nodiscard]] std::span<const InputRun> GetInputRuns() const { return inputRuns_; }
+    [[nodiscard]] std::span<const ReplayKeyframe> GetKeyframes() const { return keyframeIndex_; }
+
+    void Write(core::BinaryWriter& writer) const;
+    bool WriteToFile(std::string_view path) const;
+private:
+    bool isRecording_ = false;
+    core::Pcg32 random_;
+    std::uint64_t levelHash_ = 0;
+    std::vector<ReplaySpawn> spawns_;
+    std::vector<InputRun> inputRuns_;
+    std::vector<Frame> validateFrames_;
+    Frame frameCount_ = 0;
+    /**
+     * \brief All the keyframes worlds, each aligned on core::BINARY_ALIGNMENT.
+     * The offsets of keyframeIndex_ are relative to its start until the replay is written.
+     */
+    std::vector<std::byte> keyframes_;
+    std::vector<ReplayKeyframe> keyframeIndex_;
+    Frame keyframeInterval_ = REPLAY_KEYFRAME_INTERVAL;
+};
+
+/**
+ * \brief ReplayReader is a class that reads a replay file in place, from a memory mapped file or a buffer.
+ */
+class ReplayReader
+{
+public:
+    /**
+     * \brief Open is a method that maps a replay file and checks its blocks.
+     * \return false if the file cannot be read or is not a valid replay
+     */
+    bool Open(std::string_view path);
+    /**
+     * \brief Read is a method that reads a replay from a buffer that must outlive the reader.
+     */
+    bool Read(std::span<const std::byte> buffer);
+    [[nodiscard]] bool IsValid() const { return isValid_; }
+    [[nodiscard]] const core::Pcg32& GetRandom() const { return random_; }
+    [[nodiscard]] std::uint64_t GetLevelHash() const { return levelHash_; }
+    [[nodiscard]] std::span<const ReplaySpawn> GetSpawns() const { return spawns_; }
+    [[nodiscard]] std::span<const InputRun> GetInputRuns() const { return inputRuns_; }
+    [[nodiscard]] Frame GetFrameCount() const { return frameCount_; }
+    /**
+     * \brief GetInputs is a method that gives the validated inputs of all the players at a frame.
+     * \param frame is a frame between 1 and GetFrameCount()
+     */
+    [[nodiscard]] std::array<PlayerInput, MAX_PLAYER_NMB> GetInputs(Frame frame) const;
+    [[nodiscard]] std::span<const Frame> GetValidateFrames() const { return validateFrames_; }
+    /**
+     * \brief FindValidateFrame is a method that finds the latest validated frame at or before a frame.
+     * \return the validated frame, or 0 if no frame was validated before
+     */
+    [[nodiscard]] Frame FindValidateFrame(Frame frame) const;
+    [[nodiscard]] std::span<const ReplayKeyframe> GetKeyframes() const { return keyframes_; }
+    /**
+     * \brief FindKeyframe is a method that finds the latest keyframe at or before a frame.
+     * \return the keyframe, or nullptr if the frame is before the first keyframe
+     */
+    [[nodiscard]] const ReplayKeyframe* FindKeyframe(Frame frame) const;
+    /**
+     * \brief GetKeyframeWorld is a method that gives the serialized world of a keyframe, directly from the replay buffer.
+     */
+    [[nodiscard]] std::span<const std::byte> GetKeyframeWorld(const ReplayKeyframe& keyframe) const;
+private:
+    core::MappedFile file_;
+    std::span<const std::byte> buffer_;
+    core::Pcg32 random_;
+    std::uint64_t levelHash_ = 0;
+    std::span<const ReplaySpawn> spawns_;
+    std::span<const InputRun> inputRuns_;
+    std::span<const Frame> validateFrames_;
+    std::span<const ReplayKeyframe> keyframes_;
+    /**
+     * \brief Last frame of each input run, to find the inputs of a frame with a binary search.
+     */
+    std::vector<Frame> inputRunEndFrames_;
+    Frame frameCount_ = 0;
+    bool isValid_ = false;
+};
+}
@@ -0,0 +1,47 @@
+/**
+ * \file replay_player.h
+ */
+#pragma once
+#include "game_manager.h"
+#include "replay.h"
+
+#include <memory>
+
+namespace game
+{
+/**
+ * \brief ReplayPlayer is a class that simulates a replay on a HeadlessGameManager and can jump to any of its validated frames.
+ * Frames are validated at the same frames as in the recorded game, so the simulation gives the same result.
+ * Seeking restores the nearest keyframe at or before the frame and resimulates the remaining frames.
+ */
+class ReplayPlayer
+{
+public:
+    /**
+     * \param replay is the replay to simulate, it must outlive the player
+     */
+    explicit ReplayPlayer(const ReplayReader& replay);
+    /**
+     * \brief Restart is a method that recreates the starting world of the replay, at frame 0.
+     * \return false if the replay was recorded with another level, it cannot be simulated then
+     */
+    bool Restart();
+    /**
+     * \brief PlayTo is a method that simulates the frames until the latest validated frame of the replay at or before the given frame.
+     * Going backward is done with Seek.
+     */
+    void PlayTo(Frame frame);
+    /**
+     * \brief Seek is a method that jumps to a frame, from a keyframe when it is faster than simulating from the current frame.
+     * \return the number of simulated frames
+     */
+    Frame Seek(Frame frame);
+    [[nodiscard]] Frame GetFrame() const { return gameManager_->GetCurrentFrame(); }
+    [[nodiscard]] HeadlessGameManager& GetGameManager() { return *gameManager_; }
+    [[nodiscard]] bool IsValid() const { return isValid_; }
+private:
+    const ReplayReader& replay_;
+    std::unique_ptr<HeadlessGameManager> gameManager_;
+    bool isValid_ = false;
+};
+}
@@ -3,10 +3,15 @@
 #include "game_globals.h"
 #include "physics_manager.h"
 #include "player_character.h"
+#include "rollback_stats.h"
 #include "engine/entity.h"
 #include "engine/transform.h"
+#include "maths/random.h"
+#include "utils/serialization.h"
 #include "network/packet_type.h"
 
+#include <span>
+
 
 
 namespace game
@@ -23,12 +28,32 @@ struct CreatedEntity
 	Frame createdFrame = 0;
 };
 
+/**
+ * \brief ContactCategory is the role of an entity in a contact, used to choose the contact handler.
+ */
+enum class ContactCategory : std::uint8_t
+{
+	NONE,
+	PLAYER,
+	BULLET,
+	LENGTH
+};
+
+[[nodiscard]] constexpr ContactCategory GetContactCategory(core::EntityMask entityMask)
+{
+	if (entityMask & static_cast<core::EntityMask>(ComponentType::PLAYER_CHARACTER))
+		return ContactCategory::PLAYER;
+	if (entityMask & static_cast<core::EntityMask>(ComponentType::BULLET))
+		return ContactCategory::BULLET;
+	return ContactCategory::NONE;
+}
+
 /**
  * \brief RollbackManager is a class that manages all the rollback mechanisms of the game.
  * It contains two copies of the world (PhysicsManager, TransformManager, etc...), the current one and the validated one.
  * When receiving new information, it can reupdate the current copy of the world.
  */
-class RollbackManager final : public OnTriggerInterface
+class RollbackManager final
 {
 public:
 	explicit RollbackManager(GameManager& gameManager, core::EntityManager& entityManager);
@@ -52,6 +77,12 @@ public:
 	 * \param newValidateFrame is the new value of lastValidateFrame_
 	 */
 	void ValidateFrame(Frame newValidateFrame);
+	/**
+	 * \brief RewindToValidateFrame is a method that drops everything after the last validated frame:
+	 * the created entities, the DESTROYED flags, the current state and the received inputs.
+	 * It is used to continue a replay from a world saved while frames were not validated yet.
+	 */
+	void RewindToValidateFrame();
 	/**
 	 * \brief ConfirmFrame is a method that confirms the new validate frame by checking the Physics State checksums
 	 * It is called by the clients when receiving Confirm Frame packet
@@ -64,19 +95,90 @@ public:
 	[[nodiscard]] Frame GetLastReceivedFrame(PlayerNumber playerNumber) const { return lastReceivedFrame_[playerNumber]; }
 	[[nodiscard]] Frame GetCurrentFrame() const { return currentFrame_; }
 	[[nodiscard]] core::TransformManager& GetTransformManager() { return currentTransformManager_; }
+	/**
+	 * \brief GetTransformManager is a method that gives a read-only view of the simulated transforms.
+	 * Its dirty entities are the ones that moved since the renderer last copied them.
+	 */
+	[[nodiscard]] const core::TransformManager& GetTransformManager() const { return currentTransformManager_; }
 	[[nodiscard]] const PlayerCharacterManager& GetPlayerCharacterManager() const { return currentPlayerManager_; }
 	[[nodiscard]] PhysicsManager& GetCurrentPhysicsManager() { return currentPhysicsManager_; }
 	[[nodiscard]] BulletManager& GetCurrentBulletManager() { return currentBulletManager_; }
+	/**
+	 * \brief GetRandom is a method that gives the random generator of the current simulated frame.
+	 * Its state is restored with the rest of the game state when rollbacking, so it must be the only source of randomness of the simulation.
+	 */
+	[[nodiscard]] core::Pcg32& GetRandom() { return currentRandom_; }
+	[[nodiscard]] const core::Pcg32& GetValidateRandom() const { return lastValidateRandom_; }
+	/**
+	 * \brief SetRandomSeed is a method that seeds both the current and the last validated random generators.
+	 */
+	void SetRandomSeed(std::uint64_t seed);
+	/**
+	 * \brief SetRandom is a method that restores both the current and the last validated random generators, used to start a replay.
+	 */
+	void SetRandom(const core::Pcg32& random);
+	/**
+	 * \brief GetValidateWorldHash is a method that hashes the whole last validated state (level, frame, random generator and components).
+	 * Entity indices and order are not part of the hash, so worlds with different non-simulated entities (e.g. client graphics)
+	 * or validated with different batches of frames can be compared.
+	 */
+	[[nodiscard]] std::uint64_t GetValidateWorldHash() const;
+	/**
+	 * \brief GetCurrentWorldHash is a method that hashes the current state as it is after simulating testedFrame_,
+	 * including the created entities but not the destroyed ones.
+	 */
+	[[nodiscard]] std::uint64_t GetCurrentWorldHash() const;
+	/**
+	 * \brief SetSyncTestDepth is a method that enables the sync test mode with a depth of at least 1 frame, 0 disables it.
+	 * In sync test mode, the hash of each simulated frame is stored the first time it is simulated,
+	 * and every resimulation of this frame is compared to it, unless one of its inputs changed in-between.
+	 * The GameManager is responsible for keeping the rollback depth at syncTestDepth frames, by delaying the frames validation.
+	 */
+	void SetSyncTestDepth(Frame syncTestDepth);
+	/**
+	 * \brief SetLevel is a method that gives the static level geometry to the current and the validated physics.
+	 * The level is not part of the rollback state, it must not change during a game.
+	 */
+	void SetLevel(const Level* level);
+	/**
+	 * \brief SetPhysicsThreadCount is a method that sets the number of threads of the collision detection of the simulation.
+	 * The simulation gives the same results whatever the number of threads, so the peers can use different counts.
+	 */
+	void SetPhysicsThreadCount(std::size_t threadCount) { currentPhysicsManager_.SetThreadCount(threadCount); }
+	/**
+	 * \brief SetPhysicsSubStepCount is a method that sets the integration sub-steps of a class of bodies, in the current and the validated physics.
+	 * The sub-steps change the simulation, they must be the same for all the peers.
+	 * It is opt-in: the game keeps one sub-step per class, which is enough at FIXED_PERIOD, and only a lower tick rate needs more.
+	 */
+	void SetPhysicsSubStepCount(BodyClass bodyClass, std::uint32_t subStepCount);
+	[[nodiscard]] Frame GetSyncTestDepth() const { return syncTestDepth_; }
+	[[nodiscard]] std::uint64_t GetSyncTestChecks() const { return syncTestChecks_; }
+	[[nodiscard]] std::uint64_t GetSyncTestErrors() const { return syncTestErrors_; }
+	/**
+	 * \brief WriteState is a method that writes the whole rollback state (frames, inputs window, current and validated components) in the world blocks.
+	 */
+	void WriteState(core::BinaryWriter& writer) const;
+	/**
+	 * \brief ReadState is a method that restores the rollback state from a serialized world.
+	 * The entity masks must already be restored as they are used to check the components arrays.
+	 * \return false if a block is missing or does not match the entities
+	 */
+	bool ReadState(const core::BinaryView& view);
+	[[nodiscard]] RollbackStats& GetRollbackStats() { return rollbackStats_; }
+	[[nodiscard]] const RollbackStats& GetRollbackStats() const { return rollbackStats_; }
 	void SpawnPlayer(PlayerNumber playerNumber, core::Entity entity, core::Vec2f position, core::Vec2f lookDirection);
-	void SpawnBullet(PlayerNumber playerNumber, core::Entity entity, core::Vec2f position, core::Vec2f velocity);
+	void SpawnBullet(PlayerNumber playerNumber, core::Entity entity, core::Vec2s position, core::Vec2s velocity);
+	/**
+	 * \brief SpawnValidatedBullet is a method that adds a bullet to both the current and the last validated states.
+	 * Contrary to SpawnBullet, the bullet is not destroyed when rollbacking.
+	 */
+	void SpawnValidatedBullet(PlayerNumber playerNumber, core::Entity entity, core::Vec2f position, core::Vec2f velocity);
 	/**
 	 * \brief DestroyEntity is a method that does not destroy the entity definitely, but puts the DESTROY flag on.
 	 * An entity is truly destroyed when the destroy frame is validated.
 	 * \param entity is the entity to be "destroyed"
 	 */
 	void DestroyEntity(core::Entity entity);
-
-	void OnTrigger(core::Entity entity1, core::Entity entity2) override;
 	[[nodiscard]] const std::array<PlayerInput, WINDOW_BUFFER_SIZE>& GetInputs(PlayerNumber playerNumber) const
 	{
 		return inputs_[playerNumber];
@@ -85,6 +187,43 @@ public:
 private:
 
 	[[nodiscard]] PlayerInput GetInputAtFrame(PlayerNumber playerNumber, Frame frame) const;
+	/**
+	 * \brief GetRestoreByteSize is a method that computes the number of bytes copied when reverting to the last validated state.
+	 */
+	[[nodiscard]] std::size_t GetRestoreByteSize() const;
+	[[nodiscard]] std::uint64_t GetWorldHash(const PhysicsManager& physicsManager,
+		const PlayerCharacterManager& playerManager,
+		const BulletManager& bulletManager,
+		const core::Pcg32& random,
+		Frame frame,
+		core::EntityMask excludedMask,
+		std::span<const CreatedEntity> skippedEntities) const;
+	/**
+	 * \brief CheckSyncTest is a method that compares the current state to the first simulation of the frame, or stores it.
+	 */
+	void CheckSyncTest(Frame frame);
+	/**
+	 * \brief InvalidateSyncTest is a method that forgets the stored hashes from a frame whose input changed.
+	 */
+	void InvalidateSyncTest(Frame fromFrame);
+	/**
+	 * \brief ManageContacts is a method that applies the contacts of the last physics step of the current state, in order.
+	 * The contacts with an entity destroyed by a previous contact of the step are skipped,
+	 * the others are given to the handler of the CONTACT_HANDLERS table for the categories of their entities.
+	 */
+	void ManageContacts();
+	void ManagePlayerCollision(core::Entity player1Entity, core::Entity player2Entity, const Contact& contact);
+	void ManagePlayerBulletCollision(core::Entity playerEntity, core::Entity bulletEntity, const Contact& contact);
+	void ManageBulletPlayerCollision(core::Entity bulletEntity, core::Entity playerEntity, const Contact& contact);
+	void ManageBulletCollision(core::Entity bullet1Entity, core::Entity bullet2Entity, const Contact& contact);
+
+	using ContactHandler = void (RollbackManager::*)(core::Entity entity1, core::Entity entity2, const Contact& contact);
+	static constexpr auto CONTACT_CATEGORY_NMB = static_cast<std::size_t>(ContactCategory::LENGTH);
+	using ContactHandlerTable = std::array<std::array<ContactHandler, CONTACT_CATEGORY_NMB>, CONTACT_CATEGORY_NMB>;
+	/**
+	 * \brief CONTACT_HANDLERS is the contact handler of each pair of contact categories, nullptr when the contact has no effect.
+	 */
+	static const ContactHandlerTable CONTACT_HANDLERS;
 	GameManager& gameManager_;
 	core::EntityManager& entityManager_;
 	/**
@@ -100,6 +239,11 @@ private:
 	PhysicsManager lastValidatePhysicsManager_;
 	PlayerCharacterManager lastValidatePlayerManager_;
 	BulletManager lastValidateBulletManager_;
+	/**
+	 * \brief Random generators states, part of the rollback snapshot
+	 */
+	core::Pcg32 currentRandom_{ RANDOM_SEED };
+	core::Pcg32 lastValidateRandom_{ RANDOM_SEED };
 
 	/**
 	 * \brief lastValidateFrame_ is the last validated frame from the server side.
@@ -121,5 +265,21 @@ private:
 	 * to destroy them when rollbacking.
 	 */
 	std::vector<CreatedEntity> createdEntities_;
+	/**
+	 * \brief Cost of the rollbacks done in SimulateToCurrentFrame, displayed in the client ImGui window.
+	 */
+	RollbackStats rollbackStats_;
+	/**
+	 * \brief SyncTestHash is the hash of the first simulation of a frame, stored in a ring buffer of the size of the inputs window.
+	 */
+	struct SyncTestHash
+	{
+		Frame frame = 0;
+		std::uint64_t hash = 0;
+	};
+	std::array<SyncTestHash, WINDOW_BUFFER_SIZE> syncTestHashes_{};
+	Frame syncTestDepth_ = 0;
+	std::uint64_t syncTestChecks_ = 0;
+	std::uint64_t syncTestErrors_ = 0;
 };
 }
@@ -0,0 +1,80 @@
+#pragma once
+#include "game_globals.h"
+#include "graphics/graphics.h"
+
+#include <array>
+#include <chrono>
+
+namespace game
+{
+/**
+ * \brief RollbackStats is a class that gathers the cost of the rollback mechanism (rollback depth, resimulated frames,
+ * time per resimulated frame, bytes copied when restoring the validated state and mispredicted inputs).
+ * It is filled by the RollbackManager and can be drawn in an ImGui window or plotted with Tracy.
+ */
+class RollbackStats final : public core::DrawImGuiInterface
+{
+public:
+    /**
+     * \brief HISTORY_SIZE is the number of rollbacks kept in the plotted histories.
+     */
+    static constexpr std::size_t HISTORY_SIZE = 128;
+    /**
+     * \brief DEPTH_BUCKET_SIZE is the number of frames in one bucket of the rollback depth histogram.
+     */
+    static constexpr std::size_t DEPTH_BUCKET_SIZE = 10;
+    static constexpr std::size_t DEPTH_BUCKET_NMB = WINDOW_BUFFER_SIZE / DEPTH_BUCKET_SIZE + 1;
+
+    using Clock = std::chrono::steady_clock;
+    using Duration = std::chrono::duration<float, std::milli>;
+
+    /**
+     * \brief RecordRollback is a method called after each rollback to store its cost.
+     * \param depth is the number of resimulated frames
+     * \param copyBytes is the number of bytes copied to restore the last validated state
+     * \param duration is the total time spent to restore and resimulate
+     */
+    void RecordRollback(Frame depth, std::size_t copyBytes, Duration duration);
+    /**
+     * \brief RecordMisprediction is a method called when a received input does not match the predicted one.
+     * \param playerNumber is the player whose input was mispredicted
+     */
+    void RecordMisprediction(PlayerNumber playerNumber);
+    void Reset();
+
+    void DrawImGui() override;
+
+    [[nodiscard]] Frame GetLastDepth() const { return lastDepth_; }
+    [[nodiscard]] Frame GetMaxDepth() const { return maxDepth_; }
+    [[nodiscard]] std::uint64_t GetRollbackCount() const { return rollbackCount_; }
+    [[nodiscard]] std::uint64_t GetResimulatedFrames() const { return resimulatedFrames_; }
+    [[nodiscard]] float GetResimulatedFramesPerSecond() const { return resimulatedFramesPerSecond_; }
+    [[nodiscard]] float GetLastTimePerFrame() const { return lastTimePerFrame_; }
+    [[nodiscard]] std::size_t GetLastCopyBytes() const { return lastCopyBytes_; }
+    [[nodiscard]] std::uint64_t GetMispredictions(PlayerNumber playerNumber) const { return mispredictions_[playerNumber]; }
+
+private:
+    void PlotTracy() const;
+
+    std::array<float, HISTORY_SIZE> depthHistory_{};
+    std::array<float, HISTORY_SIZE> timePerFrameHistory_{};
+    std::array<float, HISTORY_SIZE> copyBytesHistory_{};
+    std::array<float, DEPTH_BUCKET_NMB> depthHistogram_{};
+    std::size_t historyIndex_ = 0;
+
+    Frame lastDepth_ = 0;
+    Frame maxDepth_ = 0;
+    std::uint64_t rollbackCount_ = 0;
+    std::uint64_t resimulatedFrames_ = 0;
+    /**
+     * \brief Time per resimulated frame in milliseconds of the last rollback
+     */
+    float lastTimePerFrame_ = 0.0f;
+    std::size_t lastCopyBytes_ = 0;
+    std::array<std::uint64_t, MAX_PLAYER_NMB> mispredictions_{};
+
+    Clock::time_point windowStart_ = Clock::now();
+    std::uint64_t windowResimulatedFrames_ = 0;
+    float resimulatedFramesPerSecond_ = 0.0f;
+};
+}
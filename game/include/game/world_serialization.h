@@ -0,0 +1,65 @@
+/**
+ * \file world_serialization.h
+ */
+#pragma once
+#include "maths/scalar.h"
+#include "utils/serialization.h"
+
+#include <cstdint>
+
+namespace game
+{
+/**
+ * \brief WORLD_MAGIC identifies a serialized GameManager world.
+ */
+constexpr core::BinaryMagic WORLD_MAGIC{ 'G', 'P', 'R', 'W' };
+/**
+ * \brief WORLD_VERSION is the version of the world binary format, it must be increased when a block changes its layout.
+ * Replay keyframes embed serialized worlds, so REPLAY_VERSION must be increased with it.
+ */
+constexpr std::uint32_t WORLD_VERSION = 5;
+
+/**
+ * \brief WorldBlock is the identifier of each block of a serialized world.
+ * Values must never be reused, new blocks are added at the end.
+ */
+enum class WorldBlock : std::uint32_t
+{
+    ENTITY_MASKS = 1,
+    CURRENT_FRAME,
+    WINNER,
+    PLAYER_ENTITIES,
+    TRANSFORM_POSITIONS,
+    TRANSFORM_SCALES,
+    TRANSFORM_ROTATIONS,
+
+    ROLLBACK_FRAMES,
+    LAST_RECEIVED_FRAMES,
+    INPUTS,
+    CREATED_ENTITIES,
+    ROLLBACK_TRANSFORM_POSITIONS,
+    ROLLBACK_TRANSFORM_SCALES,
+    ROLLBACK_TRANSFORM_ROTATIONS,
+    CURRENT_RIGIDBODIES,
+    CURRENT_CIRCLES,
+    CURRENT_PLAYERS,
+    CURRENT_BULLETS,
+    CURRENT_RANDOM,
+    VALIDATE_RIGIDBODIES,
+    VALIDATE_CIRCLES,
+    VALIDATE_PLAYERS,
+    VALIDATE_BULLETS,
+    VALIDATE_RANDOM,
+    SCALAR_FORMAT,
+};
+
+/**
+ * \brief WORLD_SCALAR_FORMAT is the number of fractional bits of core::Scalar, 0 for float.
+ * A world saved with the other simulation mode cannot be loaded, as its components do not have the same bits.
+ */
+#ifdef GPR_FIXED_POINT
+constexpr std::uint32_t WORLD_SCALAR_FORMAT = core::Fixed::FRACTIONAL_BITS;
+#else
+constexpr std::uint32_t WORLD_SCALAR_FORMAT = 0;
+#endif
+}
@@ -13,6 +13,22 @@ namespace game
  */
 class Server : public PacketSenderInterface, public core::SystemInterface
 {
+public:
+    /**
+     * \brief The server simulation uses all the cores for the collision detection.
+     */
+    Server();
+    /**
+     * \brief SetValidationInterval is a method that sets the minimum number of new frames received from all players before validating.
+     * A bigger interval coalesces more validation work and ValidateFramePacket, but delays the confirmation on the clients.
+     * \param validationInterval is the number of frames between two validations, at least 1
+     */
+    void SetValidationInterval(Frame validationInterval);
+    [[nodiscard]] Frame GetValidationInterval() const { return validationInterval_; }
+    /**
+     * \brief StartRecording is a method that records the game in a replay file, written when the game is won or the server ends.
+     */
+    bool StartRecording(std::string_view path) { return gameManager_.StartRecording(path); }
 protected:
 
     virtual void SpawnNewPlayer(ClientId clientId, PlayerNumber playerNumber) = 0;
@@ -21,11 +37,18 @@ protected:
      * \param packet is the received Packet.
      */
     virtual void ReceivePacket(std::unique_ptr<Packet> packet);
+    /**
+     * \brief ValidateReceivedFrames is a method called once per server tick, after receiving the packets.
+     * It validates up to the last frame received from all players, if it is at least validationInterval_ frames after the last validated frame,
+     * and sends one ValidateFramePacket for the whole batch.
+     */
+    void ValidateReceivedFrames();
 
     //Server game manager
     GameManager gameManager_;
     PlayerNumber lastPlayerNumber_ = 0;
     std::array<ClientId, MAX_PLAYER_NMB> clientMap_{};
+    Frame validationInterval_ = 1;
 
 };
 }
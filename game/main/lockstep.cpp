@@ -0,0 +1,143 @@
+#include <spdlog/spdlog.h>
+
+#include "game/game_manager.h"
+
+#include <fmt/format.h>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace
+{
+/**
+ * \brief LockstepWorld is one of the simulated games of the harness with its own input delivery schedule.
+ */
+struct LockstepWorld
+{
+    std::unique_ptr<game::HeadlessGameManager> gameManager = std::make_unique<game::HeadlessGameManager>();
+    core::Pcg32 network;
+    std::array<game::Frame, game::MAX_PLAYER_NMB> deliveredFrames{};
+};
+
+constexpr game::Frame DEFAULT_FRAMES = 10000;
+constexpr std::size_t DEFAULT_WORLDS = 4;
+constexpr game::Frame DEFAULT_MAX_DELAY = 8;
+}
+
+/**
+ * \brief lockstep runs several independent games fed with the same scripted inputs,
+ * and checks that their validated worlds have the same hash after every validated frame.
+ * The first world receives every input on time and never predicts, the other ones receive each player inputs
+ * with a random delay of up to maxDelay frames and resimulate their predicted frames every frame, like clients.
+ * All worlds validate the same frames, maxDelay frames late, like clients following the server validations.
+ * Usage: lockstep [frames] [worlds] [max delay] [seed]
+ * \return 1 at the first frame where the worlds diverge
+ */
+int main(int argc, char** argv)
+{
+    spdlog::set_level(spdlog::level::warn);
+    const game::Frame frameNmb = argc >= 2 ? static_cast<game::Frame>(std::stoul(argv[1])) : DEFAULT_FRAMES;
+    const std::size_t worldNmb = std::max<std::size_t>(2, argc >= 3 ? std::stoul(argv[2]) : DEFAULT_WORLDS);
+    const game::Frame maxDelay = std::min<game::Frame>(argc >= 4 ? static_cast<game::Frame>(std::stoul(argv[3])) : DEFAULT_MAX_DELAY,
+        game::WINDOW_BUFFER_SIZE / 2);
+    const std::uint64_t seed = argc >= 5 ? std::stoull(argv[4]) : game::RANDOM_SEED;
+
+    std::vector<LockstepWorld> worlds(worldNmb);
+    for (std::size_t worldIndex = 0; worldIndex < worlds.size(); worldIndex++)
+    {
+        auto& world = worlds[worldIndex];
+        world.network = core::Pcg32(seed, worldIndex);
+        for (game::PlayerNumber playerNumber = 0; playerNumber < game::MAX_PLAYER_NMB; playerNumber++)
+        {
+            world.gameManager->SpawnPlayer(playerNumber,
+                game::SPAWN_POSITIONS[playerNumber],
+                game::SPAWN_DIRECTION[playerNumber]);
+        }
+    }
+
+    //The scripted inputs hold each input for a random number of frames, so that the players walk, jump and charge bullets
+    core::Pcg32 script(seed);
+    std::vector<std::array<game::PlayerInput, game::MAX_PLAYER_NMB>> inputs(frameNmb + 1);
+    for (game::Frame frame = 1; frame <= frameNmb; frame++)
+    {
+        for (game::PlayerNumber playerNumber = 0; playerNumber < game::MAX_PLAYER_NMB; playerNumber++)
+        {
+            inputs[frame][playerNumber] = script.NextBounded(20) == 0 ?
+                static_cast<game::PlayerInput>(script.NextBounded(32)) : inputs[frame - 1][playerNumber];
+        }
+    }
+
+    const auto start = std::chrono::steady_clock::now();
+    game::Frame validatedFrames = 0;
+    for (game::Frame frame = 1; frame <= frameNmb + maxDelay; frame++)
+    {
+        const game::Frame lastInputFrame = std::min(frame, frameNmb);
+        const game::Frame validateFrame = frame > maxDelay ? frame - maxDelay : 0;
+        for (std::size_t worldIndex = 0; worldIndex < worlds.size(); worldIndex++)
+        {
+            auto& world = worlds[worldIndex];
+            if (frame <= frameNmb)
+            {
+                world.gameManager->AdvanceFrame();
+            }
+            for (game::PlayerNumber playerNumber = 0; playerNumber < game::MAX_PLAYER_NMB; playerNumber++)
+            {
+                //Inputs are received in order, like in the input packets that hold the last inputs of a player
+                const game::Frame delay = worldIndex == 0 ? 0 : world.network.NextBounded(maxDelay + 1);
+                const game::Frame receivedFrame = std::max(lastInputFrame > delay ? lastInputFrame - delay : 0, validateFrame);
+                for (auto& deliveredFrame = world.deliveredFrames[playerNumber]; deliveredFrame < receivedFrame; )
+                {
+                    deliveredFrame++;
+                    world.gameManager->SetPlayerInput(playerNumber, inputs[deliveredFrame][playerNumber], deliveredFrame);
+                }
+            }
+            if (worldIndex != 0)
+            {
+                world.gameManager->GetRollbackManager().SimulateToCurrentFrame();
+            }
+            if (validateFrame != 0)
+            {
+                world.gameManager->Validate(validateFrame);
+            }
+        }
+        if (validateFrame == 0)
+        {
+            continue;
+        }
+        const auto referenceHash = worlds[0].gameManager->GetRollbackManager().GetValidateWorldHash();
+        for (std::size_t worldIndex = 1; worldIndex < worlds.size(); worldIndex++)
+        {
+            const auto hash = worlds[worldIndex].gameManager->GetRollbackManager().GetValidateWorldHash();
+            if (hash != referenceHash)
+            {
+                fmt::print("Desync at validated frame {}: world 0 hash {:016x}, world {} hash {:016x}\n",
+                    validateFrame, referenceHash, worldIndex, hash);
+                return 1;
+            }
+        }
+        validatedFrames = validateFrame;
+    }
+    const std::chrono::duration<double> duration = std::chrono::steady_clock::now() - start;
+
+    std::uint64_t resimulatedFrames = 0;
+    std::uint64_t mispredictions = 0;
+    game::Frame maxDepth = 0;
+    for (const auto& world : worlds)
+    {
+        const auto& rollbackStats = world.gameManager->GetRollbackManager().GetRollbackStats();
+        resimulatedFrames += rollbackStats.GetResimulatedFrames();
+        maxDepth = std::max(maxDepth, rollbackStats.GetMaxDepth());
+        for (game::PlayerNumber playerNumber = 0; playerNumber < game::MAX_PLAYER_NMB; playerNumber++)
+        {
+            mispredictions += rollbackStats.GetMispredictions(playerNumber);
+        }
+    }
+    fmt::print("{} worlds validated {} frames with the same hash {:016x}\n",
+        worlds.size(), validatedFrames, worlds[0].gameManager->GetRollbackManager().GetValidateWorldHash());
+    fmt::print("{:.3f} ms, {:.0f} frames/s, {} resimulated frames, {} mispredictions, max rollback depth {}\n",
+        duration.count() * 1000.0,
+        duration.count() > 0.0 ? validatedFrames / duration.count() : 0.0,
+        resimulatedFrames, mispredictions, maxDepth);
+    return 0;
+}
@@ -0,0 +1,88 @@
+#include <spdlog/spdlog.h>
+
+#include "game/replay_player.h"
+
+#include <fmt/format.h>
+#include <chrono>
+#include <string>
+
+namespace
+{
+void PrintState(game::ReplayPlayer& replayPlayer)
+{
+    auto& gameManager = replayPlayer.GetGameManager();
+    const auto& rollbackManager = gameManager.GetRollbackManager();
+    for (game::PlayerNumber playerNumber = 0; playerNumber < game::MAX_PLAYER_NMB; playerNumber++)
+    {
+        fmt::print("P{} physics state: {}\n", playerNumber + 1, rollbackManager.GetValidatePhysicsState(playerNumber));
+    }
+    const auto winner = gameManager.CheckWinner();
+    if (winner != game::INVALID_PLAYER)
+    {
+        fmt::print("Winner: P{}\n", winner + 1);
+    }
+    fmt::print("World hash at frame {}: {:016x}\n", replayPlayer.GetFrame(), rollbackManager.GetValidateWorldHash());
+}
+}
+
+/**
+ * \brief replay simulates a recorded game without rendering nor networking, as fast as possible,
+ * and prints the throughput and the hash of the final validated world.
+ * With a seek frame, it first jumps to this frame from the nearest keyframe, so both results can be compared.
+ * Usage: replay <replay file> [seek frame]
+ */
+int main(int argc, char** argv)
+{
+    if (argc < 2)
+    {
+        fmt::print("Usage: {} <replay file> [seek frame]\n", argv[0]);
+        return 1;
+    }
+    spdlog::set_level(spdlog::level::warn);
+
+    game::ReplayReader replay;
+    if (!replay.Open(argv[1]))
+    {
+        return 1;
+    }
+    game::Frame targetFrame = replay.GetFrameCount();
+    const bool isSeeking = argc >= 3;
+    if (isSeeking)
+    {
+        const std::string seekFrameArg = argv[2];
+        targetFrame = replay.FindValidateFrame(static_cast<game::Frame>(std::stoul(seekFrameArg)));
+    }
+    fmt::print("Replay: {} frames, {} input runs, {} validations, {} keyframes\n",
+        replay.GetFrameCount(), replay.GetInputRuns().size(), replay.GetValidateFrames().size(), replay.GetKeyframes().size());
+
+    if (isSeeking)
+    {
+        game::ReplayPlayer seekPlayer(replay);
+        if (!seekPlayer.IsValid())
+        {
+            return 1;
+        }
+        const auto seekStart = std::chrono::steady_clock::now();
+        const auto simulatedFrames = seekPlayer.Seek(targetFrame);
+        const std::chrono::duration<double, std::milli> seekDuration = std::chrono::steady_clock::now() - seekStart;
+        fmt::print("Seek to frame {}: {:.3f} ms, {} simulated frames\n", targetFrame, seekDuration.count(), simulatedFrames);
+        PrintState(seekPlayer);
+    }
+
+    game::ReplayPlayer replayPlayer(replay);
+    if (!replayPlayer.IsValid())
+    {
+        return 1;
+    }
+    const auto start = std::chrono::steady_clock::now();
+    replayPlayer.PlayTo(targetFrame);
+    const std::chrono::duration<double> duration = std::chrono::steady_clock::now() - start;
+
+    fmt::print("Simulation to frame {}: {:.3f} ms, {:.0f} frames/s, {:.1f}x real time\n",
+        targetFrame,
+        duration.count() * 1000.0,
+        duration.count() > 0.0 ? targetFrame / duration.count() : 0.0,
+        duration.count() > 0.0 ? targetFrame * game::FIXED_PERIOD / duration.count() : 0.0);
+    PrintState(replayPlayer);
+    return 0;
+}
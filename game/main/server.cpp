@@ -5,16 +5,30 @@
 int main(int argc, char** argv)
 {
     unsigned short port = 0;
-    if (argc == 2)
+    game::Frame validationInterval = 0;
+    if (argc >= 2)
     {
         const std::string portArg = argv[1];
         port = static_cast<unsigned short>(std::stoi(portArg));
     }
+    if (argc >= 3)
+    {
+        const std::string validationIntervalArg = argv[2];
+        validationInterval = static_cast<game::Frame>(std::stoul(validationIntervalArg));
+    }
     game::NetworkServer server;
     if (port != 0)
     {
         server.SetTcpPort(port);
     }
+    if (validationInterval != 0)
+    {
+        server.SetValidationInterval(validationInterval);
+    }
+    if (argc >= 4)
+    {
+        server.StartRecording(argv[3]);
+    }
     server.Begin();
     sf::Clock clock;
     while (server.IsOpen())
@@ -22,5 +36,6 @@ int main(int argc, char** argv)
         const auto dt = clock.restart();
         server.Update(dt);
     }
+    server.End();
     return 0;
 }
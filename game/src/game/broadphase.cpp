@@ -0,0 +1,196 @@
+#include "game/broadphase.h"
+
+#include <algorithm>
+
+#ifdef TRACY_ENABLE
+#include <Tracy.hpp>
+#endif
+
+namespace game
+{
+namespace
+{
+int GetCell(core::Scalar value, float minLimit, int cellNmb)
+{
+    //Clamped as a float first, as a position far outside of the arena does not fit in an int
+    const float cell = (core::ToFloat(value) - minLimit) / UniformGridBroadphase::CELL_SIZE;
+    return static_cast<int>(std::clamp(cell, 0.0f, static_cast<float>(cellNmb - 1)));
+}
+}
+
+UniformGridBroadphase::CellRange UniformGridBroadphase::GetCellRange(core::Vec2s minBound, core::Vec2s maxBound)
+{
+    return {
+        GetCell(minBound.x, LEFT_LIMIT, COLUMN_NMB),
+        GetCell(maxBound.x, LEFT_LIMIT, COLUMN_NMB),
+        GetCell(minBound.y, LOWER_LIMIT, ROW_NMB),
+        GetCell(maxBound.y, LOWER_LIMIT, ROW_NMB)
+    };
+}
+
+void UniformGridBroadphase::FindPairs(std::span<const BroadphaseBody> bodies, std::vector<CollisionPair>& pairs)
+{
+#ifdef TRACY_ENABLE
+    ZoneScoped;
+#endif
+    pairs.clear();
+    bodyRanges_.resize(bodies.size());
+    minBounds_.resize(bodies.size());
+    maxBounds_.resize(bodies.size());
+    cellStarts_.assign(CELL_NMB + 1, 0);
+    //Counting sort of the bodies in the cells they overlap, the bodies stay sorted by entity in each cell
+    for (std::size_t i = 0; i < bodies.size(); i++)
+    {
+        minBounds_[i] = bodies[i].GetMinBound();
+        maxBounds_[i] = bodies[i].GetMaxBound();
+        const auto range = GetCellRange(minBounds_[i], maxBounds_[i]);
+        bodyRanges_[i] = range;
+        for (int row = range.minRow; row <= range.maxRow; row++)
+        {
+            for (int column = range.minColumn; column <= range.maxColumn; column++)
+            {
+                cellStarts_[row * COLUMN_NMB + column + 1]++;
+            }
+        }
+    }
+    for (int cell = 0; cell < CELL_NMB; cell++)
+    {
+        cellStarts_[cell + 1] += cellStarts_[cell];
+    }
+    cellBodies_.resize(cellStarts_[CELL_NMB]);
+    auto cellEnds = cellStarts_;
+    for (std::size_t i = 0; i < bodies.size(); i++)
+    {
+        const auto& range = bodyRanges_[i];
+        for (int row = range.minRow; row <= range.maxRow; row++)
+        {
+            for (int column = range.minColumn; column <= range.maxColumn; column++)
+            {
+                cellBodies_[cellEnds[row * COLUMN_NMB + column]++] = static_cast<std::uint32_t>(i);
+            }
+        }
+    }
+
+    for (int cell = 0; cell < CELL_NMB; cell++)
+    {
+        const int row = cell / COLUMN_NMB;
+        const int column = cell % COLUMN_NMB;
+        for (auto i = cellStarts_[cell]; i < cellStarts_[cell + 1]; i++)
+        {
+            const auto body1 = cellBodies_[i];
+            const auto& range1 = bodyRanges_[body1];
+            for (auto j = i + 1; j < cellStarts_[cell + 1]; j++)
+            {
+                const auto body2 = cellBodies_[j];
+                const auto& range2 = bodyRanges_[body2];
+                //A pair sharing several cells is only added in the first one
+                if (std::max(range1.minRow, range2.minRow) != row || std::max(range1.minColumn, range2.minColumn) != column)
+                {
+                    continue;
+                }
+                if (!bodies[body1].filter.CanCollide(bodies[body2].filter))
+                {
+                    continue;
+                }
+                if (maxBounds_[body1].x < minBounds_[body2].x || maxBounds_[body2].x < minBounds_[body1].x ||
+                    maxBounds_[body1].y < minBounds_[body2].y || maxBounds_[body2].y < minBounds_[body1].y)
+                {
+                    continue;
+                }
+                pairs.push_back({ bodies[body1].entity, bodies[body2].entity, body1, body2 });
+            }
+        }
+    }
+    std::sort(pairs.begin(), pairs.end());
+}
+
+void SweepAndPruneBroadphase::FindPairs(std::span<const BroadphaseBody> bodies, std::vector<CollisionPair>& pairs)
+{
+#ifdef TRACY_ENABLE
+    ZoneScoped;
+#endif
+    pairs.clear();
+    entries_.clear();
+    core::Entity entityNmb = 0;
+    for (const auto& body : bodies)
+    {
+        entityNmb = std::max(entityNmb, body.entity + 1);
+    }
+    for (const auto entity : order_)
+    {
+        entityNmb = std::max(entityNmb, entity + 1);
+    }
+    entityBodies_.assign(entityNmb, INVALID_BODY);
+    for (std::uint32_t i = 0; i < bodies.size(); i++)
+    {
+        entityBodies_[bodies[i].entity] = i;
+    }
+    const auto addEntry = [this, &bodies](std::uint32_t body)
+    {
+        const auto minBound = bodies[body].GetMinBound();
+        const auto maxBound = bodies[body].GetMaxBound();
+        entries_.push_back({
+            minBound.x,
+            maxBound.x,
+            minBound.y,
+            maxBound.y,
+            bodies[body].entity,
+            body });
+        //Marks the body as added
+        entityBodies_[bodies[body].entity] = INVALID_BODY;
+    };
+    //The colliders keep their previous order, the new ones are added at the end
+    for (const auto entity : order_)
+    {
+        if (entityBodies_[entity] != INVALID_BODY)
+        {
+            addEntry(entityBodies_[entity]);
+        }
+    }
+    for (std::uint32_t i = 0; i < bodies.size(); i++)
+    {
+        if (entityBodies_[bodies[i].entity] == i)
+        {
+            addEntry(i);
+        }
+    }
+
+    lastSwapCount_ = 0;
+    for (std::size_t i = 1; i < entries_.size(); i++)
+    {
+        const auto entry = entries_[i];
+        auto j = i;
+        for (; j > 0 && (entry.minX < entries_[j - 1].minX ||
+            (entry.minX == entries_[j - 1].minX && entry.entity < entries_[j - 1].entity)); j--)
+        {
+            entries_[j] = entries_[j - 1];
+        }
+        entries_[j] = entry;
+        lastSwapCount_ += i - j;
+    }
+    order_.resize(entries_.size());
+    for (std::size_t i = 0; i < entries_.size(); i++)
+    {
+        order_[i] = entries_[i].entity;
+    }
+
+    for (std::size_t i = 0; i < entries_.size(); i++)
+    {
+        const auto& entry1 = entries_[i];
+        const auto& body1 = bodies[entry1.body];
+        for (auto j = i + 1; j < entries_.size() && entries_[j].minX <= entry1.maxX; j++)
+        {
+            const auto& entry2 = entries_[j];
+            const auto& body2 = bodies[entry2.body];
+            if (entry1.maxY < entry2.minY || entry2.maxY < entry1.minY || !body1.filter.CanCollide(body2.filter))
+            {
+                continue;
+            }
+            pairs.push_back(body1.entity < body2.entity ?
+                CollisionPair{ body1.entity, body2.entity, entries_[i].body, entries_[j].body } :
+                CollisionPair{ body2.entity, body1.entity, entries_[j].body, entries_[i].body });
+        }
+    }
+    std::sort(pairs.begin(), pairs.end());
+}
+}
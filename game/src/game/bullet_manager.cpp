@@ -18,6 +18,7 @@ void BulletManager::FixedUpdate(sf::Time dt) const
 #ifdef TRACY_ENABLE
     ZoneScoped;
 #endif
+    const core::Scalar dtSeconds = dt.asSeconds();
     for (core::Entity entity = 0; entity < entityManager_.GetEntitiesSize(); entity++)
     {
         if(entityManager_.HasComponent(entity, static_cast<core::EntityMask>(ComponentType::DESTROYED)))
@@ -31,21 +32,31 @@ void BulletManager::FixedUpdate(sf::Time dt) const
             auto bulletBody = physicsManager_.GetRigidbody(entity);
 
             //Increasing Collider radius
-            CircleCollider bulletCircle{};
+            auto bulletCircle = physicsManager_.GetCircle(entity);
             bulletCircle.radius = bullet.power / (BULLET_SCALE * 1.5f) + 0.1f;
             physicsManager_.SetCircle(entity, bulletCircle);
 
             //Increasing Scale
-            const core::Vec2f bulletScale{ bullet.power + BULLET_SCALE / 2,bullet.power + BULLET_SCALE / 2 };
+            const float bulletPower = core::ToFloat(bullet.power);
+            const core::Vec2f bulletScale{ bulletPower + BULLET_SCALE / 2,bulletPower + BULLET_SCALE / 2 };
             gameManager_.GetRollbackManager().GetTransformManager().SetScale(entity, bulletScale);
             
             if(bulletBody.velocity.x > 0.0f)
             {
-                bulletBody.rotation += dt.asSeconds() * BULLET_ROTATION_SPEED;
+                bulletBody.rotation += dtSeconds * BULLET_ROTATION_SPEED;
             }
             else
             {
-                bulletBody.rotation -= dt.asSeconds() * BULLET_ROTATION_SPEED;
+                bulletBody.rotation -= dtSeconds * BULLET_ROTATION_SPEED;
+            }
+            //Keep the rotation in [0, 360), so that it never leaves the fixed-point range
+            if (bulletBody.rotation >= 360.0f)
+            {
+                bulletBody.rotation -= 360.0f;
+            }
+            else if (bulletBody.rotation < 0.0f)
+            {
+                bulletBody.rotation += 360.0f;
             }
             physicsManager_.SetRigidbody(entity, bulletBody);
            
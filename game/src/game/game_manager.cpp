@@ -2,11 +2,14 @@
 #include "filesystem"
 
 #include "game/game_manager.h"
+#include "game/world_serialization.h"
 
+#include "utils/assert.h"
 #include "utils/log.h"
 
 #include "maths/basic.h"
 #include "utils/conversion.h"
+#include "utils/mapped_file.h"
 
 #include <fmt/format.h>
 #include <imgui.h>
@@ -24,6 +27,23 @@ GameManager::GameManager() :
 	rollbackManager_(*this, entityManager_)
 {
 	playerEntityMap_.fill(core::INVALID_ENTITY);
+	rollbackManager_.SetLevel(&level_);
+	//Without its level, this instance would silently simulate another world than its peers and replays
+	if (!LoadLevel(LEVEL_PATH))
+	{
+		core::LogError(fmt::format("[GameManager] Could not load level {}, the simulation will not match the other peers", LEVEL_PATH));
+		gpr_assert(false, fmt::format("Level {} is needed by the simulation", LEVEL_PATH));
+	}
+}
+
+bool GameManager::LoadLevel(std::string_view path)
+{
+	if (!level_.LoadFromFile(path))
+	{
+		return false;
+	}
+	core::LogDebug(fmt::format("[GameManager] Loaded level {} with {} colliders", path, level_.GetColliders().size()));
+	return true;
 }
 
 void GameManager::SpawnPlayer(PlayerNumber playerNumber, core::Vec2f position, core::Vec2f direction)
@@ -37,6 +57,9 @@ void GameManager::SpawnPlayer(PlayerNumber playerNumber, core::Vec2f position, c
 	transformManager_.AddComponent(entity);
 	transformManager_.SetPosition(entity, position);
 	rollbackManager_.SpawnPlayer(playerNumber, entity, position, direction);
+
+	playerSpawns_[playerNumber] = ReplaySpawn{ position, direction, playerNumber };
+	replayRecorder_.RecordSpawn(playerNumber, position, direction);
 }
 core::Entity GameManager::GetEntityFromPlayerNumber(PlayerNumber playerNumber) const
 {
@@ -62,12 +85,12 @@ void GameManager::Validate(Frame newValidateFrame)
 	}
 	rollbackManager_.ValidateFrame(newValidateFrame);
 }
-core::Entity GameManager::SpawnBullet(PlayerNumber playerNumber, core::Vec2f position, core::Vec2f velocity)
+core::Entity GameManager::SpawnBullet(PlayerNumber playerNumber, core::Vec2s position, core::Vec2s velocity)
 {
 	const core::Entity entity = entityManager_.CreateEntity();
 
 	transformManager_.AddComponent(entity);
-	transformManager_.SetPosition(entity, position);
+	transformManager_.SetPosition(entity, core::ToVec2f(position));
 	transformManager_.SetScale(entity, core::Vec2f::one() * BULLET_SCALE);
 	transformManager_.SetRotation(entity, core::Degree(0.0f));
 	rollbackManager_.SpawnBullet(playerNumber, entity, position, velocity);
@@ -100,6 +123,193 @@ PlayerNumber GameManager::CheckWinner() const
 void GameManager::WinGame(PlayerNumber winner)
 {
 	winner_ = winner;
+	if (IsRecording())
+	{
+		StopRecording();
+	}
+}
+
+bool GameManager::StartRecording(std::string_view path)
+{
+	if (rollbackManager_.GetLastValidateFrame() != 0)
+	{
+		core::LogWarning(fmt::format("Cannot record a replay after frame {} was validated", rollbackManager_.GetLastValidateFrame()));
+		return false;
+	}
+	replayPath_ = path;
+	replayRecorder_.Start(rollbackManager_.GetValidateRandom(), level_.GetHash());
+	for (const auto& spawn : playerSpawns_)
+	{
+		if (spawn.playerNumber != INVALID_PLAYER)
+		{
+			replayRecorder_.RecordSpawn(static_cast<PlayerNumber>(spawn.playerNumber), spawn.position, spawn.direction);
+		}
+	}
+	return true;
+}
+
+bool GameManager::StopRecording()
+{
+	if (!IsRecording())
+	{
+		return false;
+	}
+	replayRecorder_.Stop();
+	return replayRecorder_.WriteToFile(replayPath_);
+}
+
+void GameManager::WriteWorld(core::BinaryWriter& writer) const
+{
+
+#ifdef TRACY_ENABLE
+	ZoneScoped;
+#endif
+	writer.WriteValue(static_cast<std::uint32_t>(WorldBlock::SCALAR_FORMAT), WORLD_SCALAR_FORMAT);
+	writer.WriteBlock(static_cast<std::uint32_t>(WorldBlock::ENTITY_MASKS), entityManager_.GetAllEntityMasks());
+	writer.WriteValue(static_cast<std::uint32_t>(WorldBlock::CURRENT_FRAME), currentFrame_);
+	writer.WriteValue(static_cast<std::uint32_t>(WorldBlock::WINNER), winner_);
+	writer.WriteValue(static_cast<std::uint32_t>(WorldBlock::PLAYER_ENTITIES), playerEntityMap_);
+	writer.WriteBlock(static_cast<std::uint32_t>(WorldBlock::TRANSFORM_POSITIONS), transformManager_.GetAllPositions());
+	writer.WriteBlock(static_cast<std::uint32_t>(WorldBlock::TRANSFORM_SCALES), transformManager_.GetAllScales());
+	writer.WriteBlock(static_cast<std::uint32_t>(WorldBlock::TRANSFORM_ROTATIONS), transformManager_.GetAllRotations());
+	rollbackManager_.WriteState(writer);
+}
+
+std::vector<std::byte> GameManager::SaveWorld() const
+{
+	core::BinaryWriter writer(WORLD_MAGIC, WORLD_VERSION);
+	WriteWorld(writer);
+	return std::move(writer.GetBuffer());
+}
+
+bool GameManager::SaveWorldToFile(std::string_view path) const
+{
+	core::BinaryWriter writer(WORLD_MAGIC, WORLD_VERSION);
+	WriteWorld(writer);
+	return writer.WriteToFile(path);
+}
+
+bool GameManager::LoadWorld(const core::BinaryView& view)
+{
+
+#ifdef TRACY_ENABLE
+	ZoneScoped;
+#endif
+	if (!view.IsValid())
+	{
+		core::LogError("Invalid serialized world");
+		return false;
+	}
+	//Worlds saved before the fixed-point mode do not have a scalar format block, and are float worlds
+	const auto* scalarFormat = view.GetValue<std::uint32_t>(static_cast<std::uint32_t>(WorldBlock::SCALAR_FORMAT));
+	const std::uint32_t worldScalarFormat = scalarFormat != nullptr ? *scalarFormat : 0;
+	if (worldScalarFormat != WORLD_SCALAR_FORMAT)
+	{
+		core::LogError(fmt::format("Serialized world scalar format {} does not match the simulation scalar format {}",
+			worldScalarFormat, WORLD_SCALAR_FORMAT));
+		return false;
+	}
+	const auto entityMasks = view.GetBlock<core::EntityMask>(static_cast<std::uint32_t>(WorldBlock::ENTITY_MASKS));
+	const auto* currentFrame = view.GetValue<Frame>(static_cast<std::uint32_t>(WorldBlock::CURRENT_FRAME));
+	const auto* winner = view.GetValue<PlayerNumber>(static_cast<std::uint32_t>(WorldBlock::WINNER));
+	const auto* playerEntities = view.GetValue<decltype(playerEntityMap_)>(static_cast<std::uint32_t>(WorldBlock::PLAYER_ENTITIES));
+	const auto positions = view.GetBlock<core::Vec2f>(static_cast<std::uint32_t>(WorldBlock::TRANSFORM_POSITIONS));
+	const auto scales = view.GetBlock<core::Vec2f>(static_cast<std::uint32_t>(WorldBlock::TRANSFORM_SCALES));
+	const auto rotations = view.GetBlock<core::Degree>(static_cast<std::uint32_t>(WorldBlock::TRANSFORM_ROTATIONS));
+	if (entityMasks.empty() || currentFrame == nullptr || winner == nullptr || playerEntities == nullptr)
+	{
+		core::LogError("Serialized world is missing game blocks");
+		return false;
+	}
+	const auto transformSize = std::min({ positions.size(), scales.size(), rotations.size() });
+	for (core::Entity entity = 0; entity < entityMasks.size(); entity++)
+	{
+		if (entityMasks[entity] & static_cast<core::EntityMask>(core::ComponentType::TRANSFORM) && entity >= transformSize)
+		{
+			core::LogError("Serialized world transforms do not match its entities");
+			return false;
+		}
+	}
+	//The rollback blocks are checked against the new entities, the old ones are put back if they do not match
+	const auto previousEntityMasks = entityManager_.GetAllEntityMasks();
+	entityManager_.CopyAllEntityMasks(entityMasks);
+	if (!rollbackManager_.ReadState(view))
+	{
+		entityManager_.CopyAllEntityMasks(previousEntityMasks);
+		return false;
+	}
+	currentFrame_ = *currentFrame;
+	winner_ = *winner;
+	playerEntityMap_ = *playerEntities;
+	transformManager_.CopyAllComponents(positions, scales, rotations);
+	return true;
+}
+
+bool GameManager::LoadWorld(std::span<const std::byte> buffer)
+{
+	return LoadWorld(core::BinaryView(buffer, WORLD_MAGIC, WORLD_VERSION));
+}
+
+bool GameManager::LoadWorldFromFile(std::string_view path)
+{
+	const core::MappedFile file(path);
+	if (!file.IsOpen())
+	{
+		return false;
+	}
+	return LoadWorld(file.GetData());
+}
+
+void HeadlessGameManager::AdvanceFrame()
+{
+	currentFrame_++;
+	rollbackManager_.StartNewFrame(currentFrame_);
+}
+
+core::Entity HeadlessGameManager::SpawnValidatedBullet(PlayerNumber playerNumber, core::Vec2f position, core::Vec2f velocity)
+{
+	const core::Entity entity = entityManager_.CreateEntity();
+
+	transformManager_.AddComponent(entity);
+	transformManager_.SetPosition(entity, position);
+	transformManager_.SetScale(entity, core::Vec2f::one() * BULLET_SCALE);
+	transformManager_.SetRotation(entity, core::Degree(0.0f));
+	rollbackManager_.SpawnValidatedBullet(playerNumber, entity, position, velocity);
+	return entity;
+}
+
+bool HeadlessGameManager::StartReplay(const ReplayReader& replay)
+{
+	if (replay.GetLevelHash() != level_.GetHash())
+	{
+		core::LogError(fmt::format("Replay level hash {:016x} does not match the loaded level hash {:016x}",
+			replay.GetLevelHash(), level_.GetHash()));
+		return false;
+	}
+	rollbackManager_.SetRandom(replay.GetRandom());
+	//Players are spawned in player number order, like on the server
+	for (PlayerNumber playerNumber = 0; playerNumber < MAX_PLAYER_NMB; playerNumber++)
+	{
+		for (const auto& spawn : replay.GetSpawns())
+		{
+			if (spawn.playerNumber == playerNumber)
+			{
+				SpawnPlayer(playerNumber, spawn.position, spawn.direction);
+			}
+		}
+	}
+	return true;
+}
+
+bool HeadlessGameManager::LoadKeyframe(std::span<const std::byte> world)
+{
+	if (!LoadWorld(world))
+	{
+		return false;
+	}
+	rollbackManager_.RewindToValidateFrame();
+	currentFrame_ = rollbackManager_.GetLastValidateFrame();
+	return true;
 }
 
 ClientGameManager::ClientGameManager(PacketSenderInterface& packetSenderInterface) :
@@ -131,6 +341,7 @@ void ClientGameManager::Begin()
 		core::LogError("Could not wall sprite");
 	}
 	CreateBackground();
+	CreateLevel();
 
 	//load PlayerCharacter Textures
 	animationManager_.LoadTexture("cat_idle", animationManager_.catIdle);
@@ -156,49 +367,61 @@ void ClientGameManager::Update(sf::Time dt)
 	if (state_ & STARTED)
 	{
 		rollbackManager_.SimulateToCurrentFrame();
-		//Copy rollback transform position to our own
-		for (core::Entity entity = 0; entity < entityManager_.GetEntitiesSize(); entity++)
+		//Copy the rollback transforms that changed since the last update to our own
+		auto& rollbackTransformManager = rollbackManager_.GetTransformManager();
+		for (const auto entity : rollbackTransformManager.GetDirtyEntities())
 		{
 			//Update Entities (BULLET)
 			if (entityManager_.HasComponent(entity, static_cast<core::EntityMask>(ComponentType::BULLET)))
 			{
-				transformManager_.SetScale(entity, rollbackManager_.GetTransformManager().GetScale(entity));
-				transformManager_.SetPosition(entity, rollbackManager_.GetTransformManager().GetPosition(entity));
-				transformManager_.SetRotation(entity, rollbackManager_.GetTransformManager().GetRotation(entity));
+				transformManager_.SetScale(entity, rollbackTransformManager.GetScale(entity));
+				transformManager_.SetPosition(entity, rollbackTransformManager.GetPosition(entity));
+				transformManager_.SetRotation(entity, rollbackTransformManager.GetRotation(entity));
+			}
+			else if (entityManager_.HasComponent(entity,
+				static_cast<core::EntityMask>(ComponentType::PLAYER_CHARACTER) |
+				static_cast<core::EntityMask>(core::ComponentType::TRANSFORM)))
+			{
+				transformManager_.SetPosition(entity, rollbackTransformManager.GetPosition(entity));
+				transformManager_.SetRotation(entity, rollbackTransformManager.GetRotation(entity));
 			}
-			//Update Entities with PLAYER_CHARACTER
-			if (entityManager_.HasComponent(entity,
+		}
+		rollbackTransformManager.ClearDirtyEntities();
+		//Update Entities with PLAYER_CHARACTER
+		for (const auto entity : playerEntityMap_)
+		{
+			if (entity == core::INVALID_ENTITY || !entityManager_.HasComponent(entity,
 				static_cast<core::EntityMask>(ComponentType::PLAYER_CHARACTER) |
 				static_cast<core::EntityMask>(core::ComponentType::SPRITE) |
 				static_cast<core::EntityMask>(core::ComponentType::TRANSFORM)))
 			{
-				auto& player = rollbackManager_.GetPlayerCharacterManager().GetComponent(entity);
+				continue;
+			}
+			auto& player = rollbackManager_.GetPlayerCharacterManager().GetComponent(entity);
 
-				if (player.invincibilityTime > 0.0f)
-				{
-					auto leftV = std::fmod(player.invincibilityTime, INVINCIBILITY_FLASH_PERIOD);
-					auto rightV = INVINCIBILITY_FLASH_PERIOD / 2.0f;
-					core::LogDebug(fmt::format("Comparing {} and {} with time: {}", leftV, rightV, player.invincibilityTime));
-				}
+			const float invincibilityTime = core::ToFloat(player.invincibilityTime);
+			if (invincibilityTime > 0.0f)
+			{
+				auto leftV = std::fmod(invincibilityTime, INVINCIBILITY_FLASH_PERIOD);
+				auto rightV = INVINCIBILITY_FLASH_PERIOD / 2.0f;
+				core::LogDebug(fmt::format("Comparing {} and {} with time: {}", leftV, rightV, invincibilityTime));
+			}
 
-				if (player.invincibilityTime > 0.0f &&
-					std::fmod(player.invincibilityTime, INVINCIBILITY_FLASH_PERIOD) > INVINCIBILITY_FLASH_PERIOD / 2.0f)
-				{
-					spriteManager_.SetColor(entity, sf::Color::Black);
-				}
-				else
-				{
-					spriteManager_.SetColor(entity, PLAYER_COLORS[player.playerNumber]);
-				}
-				//Updates the animations
-				animationManager_.UpdateEntity(entity, player.animationState, dt);
-				//Plays the correct sound on the entity according to its state
-				soundManager_.PlaySound(entity);
-
-				transformManager_.SetPosition(entity, rollbackManager_.GetTransformManager().GetPosition(entity));
-				transformManager_.SetScale(entity, core::Vec2f{ player.lookDir.x * PLAYER_SCALE.x, PLAYER_SCALE.y });
-				transformManager_.SetRotation(entity, rollbackManager_.GetTransformManager().GetRotation(entity));
+			if (invincibilityTime > 0.0f &&
+				std::fmod(invincibilityTime, INVINCIBILITY_FLASH_PERIOD) > INVINCIBILITY_FLASH_PERIOD / 2.0f)
+			{
+				spriteManager_.SetColor(entity, sf::Color::Black);
+			}
+			else
+			{
+				spriteManager_.SetColor(entity, PLAYER_COLORS[player.playerNumber]);
 			}
+			//Updates the animations
+			animationManager_.UpdateEntity(entity, player.animationState, dt);
+			//Plays the correct sound on the entity according to its state
+			soundManager_.PlaySound(entity);
+
+			transformManager_.SetScale(entity, core::Vec2f{ core::ToFloat(player.lookDir.x) * PLAYER_SCALE.x, PLAYER_SCALE.y });
 		}
 	}
 	fixedTimer_ += dt.asSeconds();
@@ -210,6 +433,10 @@ void ClientGameManager::Update(sf::Time dt)
 }
 void ClientGameManager::End()
 {
+	if (IsRecording())
+	{
+		StopRecording();
+	}
 }
 void ClientGameManager::SetWindowSize(sf::Vector2u windowsSize)
 {
@@ -311,7 +538,7 @@ void ClientGameManager::Draw(sf::RenderTarget& target)
 				continue;
 			}
 			transformManager_.SetScale(healthBarMap[playerNumber], core::Vec2f{
-			HEALTH_BAR_SCALE.x * static_cast<float>(playerManager.GetComponent(playerEntity).health)/ static_cast<float>(PLAYER_HEALTH),
+			HEALTH_BAR_SCALE.x * core::ToFloat(playerManager.GetComponent(playerEntity).health)/ static_cast<float>(PLAYER_HEALTH),
 				HEALTH_BAR_SCALE.y });
 		}
 	}
@@ -333,7 +560,7 @@ void ClientGameManager::SpawnPlayer(PlayerNumber playerNumber, core::Vec2f posit
 	animationManager_.AddComponent(entity);
 	soundManager_.AddComponent(entity);
 }
-core::Entity ClientGameManager::SpawnBullet(PlayerNumber playerNumber, core::Vec2f position, core::Vec2f velocity)
+core::Entity ClientGameManager::SpawnBullet(PlayerNumber playerNumber, core::Vec2s position, core::Vec2s velocity)
 {
 	const auto entity = GameManager::SpawnBullet(playerNumber, position, velocity);
 
@@ -404,6 +631,12 @@ void ClientGameManager::FixedUpdate()
 
 	currentFrame_++;
 	rollbackManager_.StartNewFrame(currentFrame_);
+	if (rollbackManager_.GetSyncTestDepth() != 0)
+	{
+		ConfirmPendingFrames();
+		//Every fixed frame is resimulated, even when the rendering is slower than the fixed period
+		rollbackManager_.SimulateToCurrentFrame();
+	}
 }
 void ClientGameManager::SetPlayerInput(PlayerNumber playerNumber, PlayerInput playerInput, std::uint32_t inputFrame)
 {
@@ -430,9 +663,44 @@ void ClientGameManager::DrawImGui()
 		ImGui::Text("Current Time: %llu", ms);
 	}
 	ImGui::Checkbox("Draw Physics", &drawPhysics_);
+	if (IsRecording())
+	{
+		ImGui::Text("Recording replay: %u frames", replayRecorder_.GetFrameCount());
+		if (ImGui::Button("Stop Recording"))
+		{
+			StopRecording();
+		}
+	}
+	else if (GetLastValidateFrame() == 0 && ImGui::Button("Record Replay"))
+	{
+		StartRecording(fmt::format("replay_p{}.gprr", clientPlayer_ == INVALID_PLAYER ? 0 : clientPlayer_ + 1));
+	}
+	int syncTestDepth = static_cast<int>(rollbackManager_.GetSyncTestDepth());
+	if (ImGui::SliderInt("Sync Test Depth", &syncTestDepth, 0, static_cast<int>(MAX_SYNC_TEST_DEPTH)))
+	{
+		SetSyncTestDepth(static_cast<Frame>(syncTestDepth));
+	}
+	if (syncTestDepth != 0)
+	{
+		ImGui::Text("Sync test: %llu checked frames, %llu errors",
+			static_cast<unsigned long long>(rollbackManager_.GetSyncTestChecks()),
+			static_cast<unsigned long long>(rollbackManager_.GetSyncTestErrors()));
+	}
+	rollbackManager_.GetRollbackStats().DrawImGui();
 }
 void ClientGameManager::ConfirmValidateFrame(Frame newValidateFrame,
 	const std::array<PhysicsState, MAX_PLAYER_NMB>& physicsStates)
+{
+	if (rollbackManager_.GetSyncTestDepth() != 0 || !pendingValidateFrames_.empty())
+	{
+		pendingValidateFrames_.push_back({ newValidateFrame, physicsStates });
+		ConfirmPendingFrames();
+		return;
+	}
+	ApplyValidateFrame(newValidateFrame, physicsStates);
+}
+void ClientGameManager::ApplyValidateFrame(Frame newValidateFrame,
+	const std::array<PhysicsState, MAX_PLAYER_NMB>& physicsStates)
 {
 	if (newValidateFrame < rollbackManager_.GetLastValidateFrame())
 	{
@@ -456,6 +724,25 @@ void ClientGameManager::ConfirmValidateFrame(Frame newValidateFrame,
 	}
 	rollbackManager_.ConfirmFrame(newValidateFrame, physicsStates);
 }
+void ClientGameManager::SetSyncTestDepth(Frame syncTestDepth)
+{
+	rollbackManager_.SetSyncTestDepth(std::min<Frame>(syncTestDepth, MAX_SYNC_TEST_DEPTH));
+	if (syncTestDepth == 0)
+	{
+		ConfirmPendingFrames();
+	}
+}
+void ClientGameManager::ConfirmPendingFrames()
+{
+	const auto syncTestDepth = rollbackManager_.GetSyncTestDepth();
+	//Validate frames are received in order, the oldest ones are confirmed first
+	auto pendingIt = pendingValidateFrames_.begin();
+	for (; pendingIt != pendingValidateFrames_.end() && pendingIt->validateFrame + syncTestDepth <= currentFrame_; ++pendingIt)
+	{
+		ApplyValidateFrame(pendingIt->validateFrame, pendingIt->physicsStates);
+	}
+	pendingValidateFrames_.erase(pendingValidateFrames_.begin(), pendingIt);
+}
 void ClientGameManager::WinGame(PlayerNumber winner)
 {
 	GameManager::WinGame(winner);
@@ -551,6 +838,43 @@ void ClientGameManager::CreateBackground()
 	spriteManager_.SetColor(entity, FLOOR_COLOR);
 }
 
+void ClientGameManager::CreateLevel()
+{
+	//The segments are drawn as thin boxes rotated along them
+	constexpr float segmentThickness = 0.1f;
+	const sf::Vector2f textureSize(wallTexture_.getSize());
+	for (const auto& collider : level_.GetColliders())
+	{
+		const auto point1 = core::ToVec2f(collider.point1);
+		const auto point2 = core::ToVec2f(collider.point2);
+		const auto center = (point1 + point2) / 2.0f;
+		const auto extent = point2 - point1;
+
+		const core::Entity entity = entityManager_.CreateEntity();
+		spriteManager_.AddComponent(entity);
+		spriteManager_.SetTexture(entity, wallTexture_);
+		spriteManager_.SetOrigin(entity, textureSize / 2.0f);
+		spriteManager_.SetColor(entity, FLOOR_COLOR);
+		transformManager_.AddComponent(entity);
+		transformManager_.SetPosition(entity, center);
+		switch (collider.shape)
+		{
+		case LevelShape::BOX:
+			transformManager_.SetScale(entity, core::Vec2f(
+				extent.x * core::PIXEL_PER_METER / textureSize.x,
+				extent.y * core::PIXEL_PER_METER / textureSize.y));
+			break;
+		case LevelShape::SEGMENT:
+			transformManager_.SetScale(entity, core::Vec2f(
+				extent.GetMagnitude() * core::PIXEL_PER_METER / textureSize.x,
+				segmentThickness * core::PIXEL_PER_METER / textureSize.y));
+			//The screen y axis goes down, so the rotation is reversed
+			transformManager_.SetRotation(entity, core::Degree(core::Atan2(-extent.y, extent.x)));
+			break;
+		}
+	}
+}
+
 void ClientGameManager::CreateHealthBar(PlayerNumber playerNumber)
 {
 	if (healthBarMap[playerNumber] != core::INVALID_ENTITY)
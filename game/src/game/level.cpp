@@ -0,0 +1,242 @@
+#include "game/level.h"
+
+#include "utils/hash.h"
+#include "utils/log.h"
+#include "utils/mapped_file.h"
+
+#include <fmt/format.h>
+
+#include <algorithm>
+#include <charconv>
+#include <numeric>
+
+#ifdef TRACY_ENABLE
+#include <Tracy.hpp>
+#endif
+
+namespace game
+{
+Aabb LevelCollider::GetBounds() const
+{
+    return {
+        { std::min(point1.x, point2.x), std::min(point1.y, point2.y) },
+        { std::max(point1.x, point2.x), std::max(point1.y, point2.y) } };
+}
+
+bool LevelCollider::FindContact(core::Vec2s center, core::Scalar radius, core::Vec2s& normal, core::Scalar& depth) const
+{
+    const core::Scalar zero = 0.0f;
+    const core::Scalar one = 1.0f;
+    core::Vec2s closest{};
+    switch (shape)
+    {
+    case LevelShape::BOX:
+    {
+        closest = { std::clamp(center.x, point1.x, point2.x), std::clamp(center.y, point1.y, point2.y) };
+        if (closest.x == center.x && closest.y == center.y)
+        {
+            //The center is inside the box, the circle is pushed out through the closest side
+            const std::array<core::Scalar, 4> sideDistances{
+                center.x - point1.x, point2.x - center.x, center.y - point1.y, point2.y - center.y };
+            const std::array<core::Vec2s, 4> sideNormals{
+                core::Vec2s::left(), core::Vec2s::right(), core::Vec2s::down(), core::Vec2s::up() };
+            const auto side = std::min_element(sideDistances.begin(), sideDistances.end()) - sideDistances.begin();
+            normal = sideNormals[side];
+            depth = sideDistances[side] + radius;
+            return true;
+        }
+        break;
+    }
+    case LevelShape::SEGMENT:
+    {
+        const core::Vec2s segment = point2 - point1;
+        const core::Scalar sqrLength = core::Vec2s::Dot(segment, segment);
+        const core::Scalar t = sqrLength > zero ?
+            std::clamp(core::Vec2s::Dot(center - point1, segment) / sqrLength, zero, one) : zero;
+        closest = point1 + segment * t;
+        if (closest.x == center.x && closest.y == center.y)
+        {
+            //The center is on the segment, the circle is pushed out on the left side of the segment
+            normal = sqrLength > zero ? core::Vec2s{ -segment.y, segment.x }.GetNormalized() : core::Vec2s::up();
+            depth = radius;
+            return true;
+        }
+        break;
+    }
+    }
+    const core::Vec2s distance = center - closest;
+    if (core::Vec2s::Dot(distance, distance) >= radius * radius)
+    {
+        return false;
+    }
+    const core::Scalar magnitude = distance.GetMagnitude();
+    normal = distance / magnitude;
+    depth = radius - magnitude;
+    return true;
+}
+
+void StaticBvh::Build(std::span<const Aabb> bounds)
+{
+#ifdef TRACY_ENABLE
+    ZoneScoped;
+#endif
+    bounds_.assign(bounds.begin(), bounds.end());
+    indices_.resize(bounds_.size());
+    std::iota(indices_.begin(), indices_.end(), 0u);
+    nodes_.clear();
+    if (bounds_.empty())
+    {
+        return;
+    }
+    nodes_.reserve(2 * (bounds_.size() / LEAF_SIZE + 1));
+    BuildNode(0, static_cast<std::uint32_t>(bounds_.size()), 0);
+}
+
+void StaticBvh::BuildNode(std::uint32_t first, std::uint32_t count, std::size_t depth)
+{
+    const auto nodeIndex = nodes_.size();
+    nodes_.emplace_back();
+    Aabb nodeBounds = bounds_[indices_[first]];
+    for (auto i = first + 1; i < first + count; i++)
+    {
+        const auto& bounds = bounds_[indices_[i]];
+        nodeBounds.min = { std::min(nodeBounds.min.x, bounds.min.x), std::min(nodeBounds.min.y, bounds.min.y) };
+        nodeBounds.max = { std::max(nodeBounds.max.x, bounds.max.x), std::max(nodeBounds.max.y, bounds.max.y) };
+    }
+    nodes_[nodeIndex].bounds = nodeBounds;
+    //The query stack holds at most one node per level
+    if (count <= LEAF_SIZE || depth + 1 >= MAX_DEPTH)
+    {
+        nodes_[nodeIndex].first = first;
+        nodes_[nodeIndex].count = count;
+        return;
+    }
+    //Median split along the longest axis of the node, the ties are ordered by index
+    const bool splitX = nodeBounds.max.x - nodeBounds.min.x >= nodeBounds.max.y - nodeBounds.min.y;
+    std::sort(indices_.begin() + first, indices_.begin() + first + count,
+        [this, splitX](std::uint32_t index1, std::uint32_t index2)
+        {
+            const auto& bounds1 = bounds_[index1];
+            const auto& bounds2 = bounds_[index2];
+            const core::Scalar center1 = splitX ? bounds1.min.x + bounds1.max.x : bounds1.min.y + bounds1.max.y;
+            const core::Scalar center2 = splitX ? bounds2.min.x + bounds2.max.x : bounds2.min.y + bounds2.max.y;
+            return center1 < center2 || (center1 == center2 && index1 < index2);
+        });
+    const auto leftCount = count / 2;
+    BuildNode(first, leftCount, depth + 1);
+    nodes_[nodeIndex].first = static_cast<std::uint32_t>(nodes_.size());
+    BuildNode(first + leftCount, count - leftCount, depth + 1);
+}
+
+bool Level::LoadFromFile(std::string_view path)
+{
+    const core::MappedFile file(path);
+    if (!file.IsOpen())
+    {
+        core::LogError(fmt::format("Could not open level file {}", path));
+        SetColliders({});
+        return false;
+    }
+    const auto data = file.GetData();
+    return LoadFromString(std::string_view(reinterpret_cast<const char*>(data.data()), data.size()));
+}
+
+bool Level::LoadFromString(std::string_view text)
+{
+    constexpr std::string_view whitespaces = " \t\r";
+    std::vector<LevelCollider> colliders;
+    std::size_t lineNumber = 0;
+    while (!text.empty())
+    {
+        lineNumber++;
+        const auto lineEnd = std::min(text.find('\n'), text.size());
+        std::string_view line = text.substr(0, lineEnd);
+        text.remove_prefix(std::min(lineEnd + 1, text.size()));
+        line = line.substr(0, line.find('#'));
+
+        //Splits the line in a keyword and four numbers
+        std::array<std::string_view, 5> tokens{};
+        std::size_t tokenCount = 0;
+        while (true)
+        {
+            const auto tokenStart = line.find_first_not_of(whitespaces);
+            if (tokenStart == std::string_view::npos)
+            {
+                break;
+            }
+            line.remove_prefix(tokenStart);
+            const auto tokenEnd = std::min(line.find_first_of(whitespaces), line.size());
+            if (tokenCount == tokens.size())
+            {
+                tokenCount++;
+                break;
+            }
+            tokens[tokenCount++] = line.substr(0, tokenEnd);
+            line.remove_prefix(tokenEnd);
+        }
+        if (tokenCount == 0)
+        {
+            continue;
+        }
+        LevelCollider collider;
+        if (tokens[0] == "box")
+        {
+            collider.shape = LevelShape::BOX;
+        }
+        else if (tokens[0] == "segment")
+        {
+            collider.shape = LevelShape::SEGMENT;
+        }
+        else
+        {
+            core::LogError(fmt::format("Unknown level collider {} at line {}", tokens[0], lineNumber));
+            SetColliders({});
+            return false;
+        }
+        std::array<float, 4> values{};
+        bool isValid = tokenCount == tokens.size();
+        for (std::size_t i = 0; i < values.size() && isValid; i++)
+        {
+            const auto& token = tokens[i + 1];
+            const auto [end, error] = std::from_chars(token.data(), token.data() + token.size(), values[i]);
+            isValid = error == std::errc() && end == token.data() + token.size();
+        }
+        if (!isValid)
+        {
+            core::LogError(fmt::format("Level {} at line {} needs four numbers", tokens[0], lineNumber));
+            SetColliders({});
+            return false;
+        }
+        collider.point1 = core::Vec2s(core::Vec2f(values[0], values[1]));
+        collider.point2 = core::Vec2s(core::Vec2f(values[2], values[3]));
+        if (collider.shape == LevelShape::BOX && (values[0] > values[2] || values[1] > values[3]))
+        {
+            core::LogError(fmt::format("Level box at line {} must go from its minimum to its maximum corner", lineNumber));
+            SetColliders({});
+            return false;
+        }
+        colliders.push_back(collider);
+    }
+    SetColliders(std::move(colliders));
+    return true;
+}
+
+void Level::SetColliders(std::vector<LevelCollider> colliders)
+{
+    colliders_ = std::move(colliders);
+    std::vector<Aabb> bounds;
+    bounds.reserve(colliders_.size());
+    core::Fnv1aHash hash;
+    for (const auto& collider : colliders_)
+    {
+        bounds.push_back(collider.GetBounds());
+        hash.Add(collider.shape);
+        hash.Add(collider.point1.x);
+        hash.Add(collider.point1.y);
+        hash.Add(collider.point2.x);
+        hash.Add(collider.point2.y);
+    }
+    bvh_.Build(bounds);
+    hash_ = hash.GetValue();
+}
+}
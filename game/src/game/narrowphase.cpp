@@ -0,0 +1,210 @@
+#include "game/narrowphase.h"
+
+#include <algorithm>
+#include <array>
+
+#ifdef TRACY_ENABLE
+#include <Tracy.hpp>
+#endif
+
+namespace game
+{
+void CircleNarrowphase::FindContacts(std::span<const BroadphaseBody> bodies,
+    std::span<const CollisionPair> pairs,
+    std::vector<Contact>& contacts)
+{
+#ifdef TRACY_ENABLE
+    ZoneScoped;
+#endif
+    contacts.clear();
+    //Structure of arrays of a batch, the lanes after the end of the last batch keep older values and are ignored
+    std::array<core::Scalar, BATCH_SIZE> distanceX{};
+    std::array<core::Scalar, BATCH_SIZE> distanceY{};
+    std::array<core::Scalar, BATCH_SIZE> radiusSum{};
+    //The overlap mask has the width of a scalar, so that the test is vectorized on full registers
+    std::array<std::int32_t, BATCH_SIZE> overlapping{};
+    for (std::size_t batchStart = 0; batchStart < pairs.size(); batchStart += BATCH_SIZE)
+    {
+        const auto batchSize = std::min(BATCH_SIZE, pairs.size() - batchStart);
+        for (std::size_t lane = 0; lane < batchSize; lane++)
+        {
+            const auto& pair = pairs[batchStart + lane];
+            const auto& body1 = bodies[pair.body1];
+            const auto& body2 = bodies[pair.body2];
+            distanceX[lane] = body2.position.x - body1.position.x;
+            distanceY[lane] = body2.position.y - body1.position.y;
+            radiusSum[lane] = body1.radius + body2.radius;
+        }
+        for (std::size_t lane = 0; lane < BATCH_SIZE; lane++)
+        {
+            overlapping[lane] = distanceX[lane] * distanceX[lane] + distanceY[lane] * distanceY[lane] <=
+                radiusSum[lane] * radiusSum[lane];
+        }
+        for (std::size_t lane = 0; lane < batchSize; lane++)
+        {
+            const auto& pair = pairs[batchStart + lane];
+            if (!overlapping[lane])
+            {
+                Contact contact{ pair.entity1, pair.entity2 };
+                if (FindSweptContact(bodies[pair.body1], bodies[pair.body2], contact))
+                {
+                    contacts.push_back(contact);
+                }
+                continue;
+            }
+            const core::Vec2s distance{ distanceX[lane], distanceY[lane] };
+            const core::Vec2s normal = distance.GetNormalized();
+            contacts.push_back({
+                pair.entity1,
+                pair.entity2,
+                normal,
+                normal * (radiusSum[lane] - distance.GetMagnitude()) });
+        }
+    }
+}
+
+bool CircleNarrowphase::FindSweptContact(const BroadphaseBody& body1, const BroadphaseBody& body2, Contact& contact)
+{
+    const core::Scalar zero = 0.0f;
+    const core::Scalar one = 1.0f;
+    //Relative motion of body2 seen from body1: start + relativeDisplacement * t, with t in [0, 1]
+    const core::Vec2s relativeDisplacement = body2.displacement - body1.displacement;
+    const core::Scalar a = core::Vec2s::Dot(relativeDisplacement, relativeDisplacement);
+    if (a == zero)
+    {
+        //Without relative motion, the end of the frame overlap test is exact
+        return false;
+    }
+    const core::Vec2s start = body2.position - body2.displacement - (body1.position - body1.displacement);
+    const core::Scalar radiusSum = body1.radius + body2.radius;
+    const core::Scalar halfB = core::Vec2s::Dot(start, relativeDisplacement);
+    const core::Scalar c = core::Vec2s::Dot(start, start) - radiusSum * radiusSum;
+    if (halfB >= zero)
+    {
+        //The circles do not get closer during the frame, and they did not overlap at its end
+        return false;
+    }
+    const core::Scalar quarterDiscriminant = halfB * halfB - a * c;
+    if (quarterDiscriminant < zero)
+    {
+        return false;
+    }
+    //First root of a*t^2 + 2*halfB*t + c, clamped to the start of the frame if the circles already overlapped there
+    const core::Scalar t = std::max(zero, (-halfB - core::Sqrt(quarterDiscriminant)) / a);
+    if (t > one)
+    {
+        return false;
+    }
+    contact.normal = (start + relativeDisplacement * t).GetNormalized();
+    contact.mtv = {};
+    return true;
+}
+
+ParallelNarrowphase::~ParallelNarrowphase()
+{
+    StopWorkers();
+}
+
+void ParallelNarrowphase::SetThreadCount(std::size_t threadCount)
+{
+    StopWorkers();
+    threadCount = std::max<std::size_t>(threadCount, 1);
+    taskContacts_.resize(threadCount);
+    isStopping_ = false;
+    generation_ = 0;
+    workers_.reserve(threadCount - 1);
+    //The calling thread tests the first range of pairs
+    for (std::size_t taskIndex = 1; taskIndex < threadCount; taskIndex++)
+    {
+        workers_.emplace_back(&ParallelNarrowphase::RunWorker, this, taskIndex);
+    }
+}
+
+void ParallelNarrowphase::FindContacts(std::span<const BroadphaseBody> bodies,
+    std::span<const CollisionPair> pairs,
+    std::vector<Contact>& contacts)
+{
+#ifdef TRACY_ENABLE
+    ZoneScoped;
+#endif
+    const auto taskCount = std::clamp<std::size_t>(pairs.size() / MIN_TASK_PAIR_NMB, 1, GetThreadCount());
+    if (taskCount == 1)
+    {
+        CircleNarrowphase::FindContacts(bodies, pairs, contacts);
+        return;
+    }
+    {
+        std::lock_guard lock(mutex_);
+        bodies_ = bodies;
+        pairs_ = pairs;
+        taskCount_ = taskCount;
+        pendingTaskCount_ = taskCount - 1;
+        generation_++;
+    }
+    startCondition_.notify_all();
+    CircleNarrowphase::FindContacts(bodies, GetTaskPairs(0), taskContacts_[0]);
+    {
+        std::unique_lock lock(mutex_);
+        doneCondition_.wait(lock, [this] { return pendingTaskCount_ == 0; });
+    }
+    //The ranges follow each other, so merging them in order gives the contacts in the order of the pairs
+    contacts.clear();
+    for (std::size_t taskIndex = 0; taskIndex < taskCount; taskIndex++)
+    {
+        contacts.insert(contacts.end(), taskContacts_[taskIndex].begin(), taskContacts_[taskIndex].end());
+    }
+}
+
+void ParallelNarrowphase::StopWorkers()
+{
+    {
+        std::lock_guard lock(mutex_);
+        isStopping_ = true;
+    }
+    startCondition_.notify_all();
+    for (auto& worker : workers_)
+    {
+        worker.join();
+    }
+    workers_.clear();
+}
+
+void ParallelNarrowphase::RunWorker(std::size_t taskIndex)
+{
+    std::uint64_t generation = 0;
+    while (true)
+    {
+        {
+            std::unique_lock lock(mutex_);
+            startCondition_.wait(lock, [this, generation] { return isStopping_ || generation_ != generation; });
+            if (isStopping_)
+            {
+                return;
+            }
+            generation = generation_;
+            //Small frames do not use all the threads
+            if (taskIndex >= taskCount_)
+            {
+                continue;
+            }
+        }
+        CircleNarrowphase::FindContacts(bodies_, GetTaskPairs(taskIndex), taskContacts_[taskIndex]);
+        bool isLastTask = false;
+        {
+            std::lock_guard lock(mutex_);
+            isLastTask = --pendingTaskCount_ == 0;
+        }
+        if (isLastTask)
+        {
+            doneCondition_.notify_one();
+        }
+    }
+}
+
+std::span<const CollisionPair> ParallelNarrowphase::GetTaskPairs(std::size_t taskIndex) const
+{
+    const auto first = taskIndex * pairs_.size() / taskCount_;
+    const auto last = (taskIndex + 1) * pairs_.size() / taskCount_;
+    return pairs_.subspan(first, last - first);
+}
+}
@@ -1,9 +1,11 @@
 #include "game/physics_manager.h"
 
 #include "engine/transform.h"
+#include "utils/assert.h"
 
-#include <SFML/Graphics/CircleShape.hpp>
-#include <SFML/Graphics/RectangleShape.hpp>
+#include <algorithm>
+#include <array>
+#include <cmath>
 
 #ifdef TRACY_ENABLE
 #include <Tracy.hpp>
@@ -16,31 +18,6 @@ PhysicsManager::PhysicsManager(core::EntityManager& entityManager) :
 	entityManager_(entityManager), rigidbodyManager_(entityManager),
 	circleColliderManager_(entityManager){}
 
-/**
- * \brief Checks for overlapping between two spheres
- * \param myCircle The first sphere to evaluate
- * \param myBody The first rigidbody to evaluate
- * \param otherCircle The second  sphere to evaluate
- * \param otherBody The second rigidbody to evaluate
- * \param mtv The minimum translation vector used in collision solving
- * \return True if two spheres are overlapping
- */
-bool IsOverlappingCircle(
-	CircleCollider myCircle, Rigidbody myBody,
-	CircleCollider otherCircle, Rigidbody otherBody,
-	core::Vec2f& mtv)
-{
-	const  core::Vec2f distance = otherBody.position - myBody.position;
-
-	const float distanceMagnitude = distance.GetMagnitude();
-	const float radiusSum = myCircle.radius + otherCircle.radius;
-
-	const float mtvDifference = radiusSum - distanceMagnitude;
-	mtv = distance.GetNormalized() * mtvDifference;
-
-	return (distanceMagnitude <= radiusSum);
-}
-
 /**
  * \brief Solves collisions between two rigidbodies
  * \param myBody The first rigidbody to evaluate and modify
@@ -48,19 +25,19 @@ bool IsOverlappingCircle(
  */
 void PhysicsManager::SolveCollision(Rigidbody& myBody, Rigidbody& otherBody)
 {
-	const core::Vec2f v1 = myBody.velocity;
-	const core::Vec2f v2 = otherBody.velocity;
+	const core::Vec2s v1 = myBody.velocity;
+	const core::Vec2s v2 = otherBody.velocity;
 
-	core::Vec2f n = core::Vec2f(otherBody.position - myBody.position).GetNormalized();
-	core::Vec2f g = n.RightOrtho();
+	core::Vec2s n = core::Vec2s(otherBody.position - myBody.position).GetNormalized();
+	core::Vec2s g = n.RightOrtho();
 
-	const float v1n = core::Vec2f::Dot(n, v1);
-	const float v1g = core::Vec2f::Dot(g, v1);
-	const float v2n = core::Vec2f::Dot(n, v2);
-	const float v2g = core::Vec2f::Dot(g, v2);
+	const core::Scalar v1n = core::Vec2s::Dot(n, v1);
+	const core::Scalar v1g = core::Vec2s::Dot(g, v1);
+	const core::Scalar v2n = core::Vec2s::Dot(n, v2);
+	const core::Scalar v2g = core::Vec2s::Dot(g, v2);
 
-	const core::Vec2f v1AfterImpact = core::Vec2f(n.x * v2n + g.x * v1g, n.y * v2n + g.y * v1g);
-	const core::Vec2f v2AfterImpact = core::Vec2f(n.x * v1n + g.x * v2g, n.y * v1n + g.y * v2g);
+	const core::Vec2s v1AfterImpact = core::Vec2s(n.x * v2n + g.x * v1g, n.y * v2n + g.y * v1g);
+	const core::Vec2s v2AfterImpact = core::Vec2s(n.x * v1n + g.x * v2g, n.y * v1n + g.y * v2g);
 
 	if (myBody.bodyType == BodyType::DYNAMIC)
 	{
@@ -86,7 +63,7 @@ void PhysicsManager::SolveCollision(Rigidbody& myBody, Rigidbody& otherBody)
  * \param otherBody The second body to be modified
  * \param mtv The minimum translation vector given to solve the new positions of rigidbodies
  */
-void PhysicsManager::SolveMTV(Rigidbody& myBody, Rigidbody& otherBody, const core::Vec2f& mtv)
+void PhysicsManager::SolveMTV(Rigidbody& myBody, Rigidbody& otherBody, const core::Vec2s& mtv)
 {
 	if (mtv.GetSqrMagnitude() > 0.0f)
 	{
@@ -98,101 +75,195 @@ void PhysicsManager::SolveMTV(Rigidbody& myBody, Rigidbody& otherBody, const cor
 }
 
 
-void PhysicsManager::ApplyGravityToRigidbodies(sf::Time dt)
+void PhysicsManager::IntegrateRigidbodies(sf::Time dt)
 {
-	//General entities
-	for (core::Entity entity = 0; entity < entityManager_.GetEntitiesSize(); entity++)
+#ifdef TRACY_ENABLE
+	ZoneScoped;
+#endif
+	constexpr auto rigidbodyMask = static_cast<core::EntityMask>(core::ComponentType::RIGIDBODY);
+	constexpr auto playerMask = static_cast<core::EntityMask>(ComponentType::PLAYER_CHARACTER);
+	constexpr auto destroyedMask = static_cast<core::EntityMask>(ComponentType::DESTROYED);
+	constexpr auto circleMask = static_cast<core::EntityMask>(core::ComponentType::CIRCLE_COLLIDER);
+	const core::Scalar dtSeconds = dt.asSeconds();
+	const core::Scalar zero = 0.0f;
+	const core::Scalar sleepVelocity = SLEEP_VELOCITY;
+	const core::Scalar sleepSqrVelocity = sleepVelocity * sleepVelocity;
+	const auto& entityMasks = entityManager_.GetAllEntityMasks();
+	//The entities that lost their rigidbody are compacted out of the list during the pass
+	std::size_t dynamicBodyNmb = 0;
+	for (std::size_t i = 0; i < dynamicBodies_.size(); i++)
 	{
-		if (!entityManager_.HasComponent(entity, static_cast<core::EntityMask>(core::ComponentType::RIGIDBODY)))
+		const core::Entity entity = dynamicBodies_[i];
+		const auto entityMask = entityMasks[entity];
+		if (!(entityMask & rigidbodyMask))
 			continue;
-		auto rigidbody = rigidbodyManager_.GetComponent(entity);
+		dynamicBodies_[dynamicBodyNmb++] = entity;
+		auto& rigidbody = rigidbodyManager_.GetComponent(entity);
 
-		//Apply gravity
-		if (rigidbody.position.y > LOWER_LIMIT && rigidbody.bodyType == BodyType::DYNAMIC)
+		if (rigidbody.IsSleeping())
+			continue;
+
+		const bool isFalling = rigidbody.position.y > LOWER_LIMIT && rigidbody.gravityScale != zero;
+		const bool isPlayer = (entityMask & playerMask) == playerMask && (entityMask & destroyedMask) != destroyedMask;
+		const auto subStepCount = subStepCounts_[static_cast<std::size_t>(GetBodyClass(entityMask))];
+		const core::Scalar subStepSeconds = subStepCount == 1 ? dtSeconds : dtSeconds / core::Scalar(static_cast<float>(subStepCount));
+		bool isResting = false;
+		for (std::uint32_t subStep = 0; subStep < subStepCount; subStep++)
 		{
-			rigidbody.velocity.y += (GRAVITY * rigidbody.gravityScale) * dt.asSeconds();
-		}
+			//Apply gravity
+			if (rigidbody.position.y > LOWER_LIMIT)
+			{
+				rigidbody.velocity.y += (GRAVITY * rigidbody.gravityScale) * subStepSeconds;
+			}
 
-		rigidbody.position += rigidbody.velocity * dt.asSeconds();
+			rigidbody.position += rigidbody.velocity * subStepSeconds;
 
-		rigidbodyManager_.SetComponent(entity, rigidbody);
-	}
-}
+			if (level_ != nullptr && (entityMask & circleMask))
+			{
+				ResolveLevelContacts(rigidbody, circleColliderManager_.GetComponent(entity).radius);
+			}
 
-void PhysicsManager::LimitPlayerMovement(sf::Time dt)
-{
-	for (core::Entity entity = 0; entity < entityManager_.GetEntitiesSize(); entity++)
-	{
-		//Check for sphere collisions
-		if (!entityManager_.HasComponent(entity,
-			static_cast<core::EntityMask>(core::ComponentType::RIGIDBODY) |
-			static_cast<core::EntityMask>(ComponentType::PLAYER_CHARACTER)) ||
-			entityManager_.HasComponent(entity, static_cast<core::EntityMask>(ComponentType::DESTROYED)))
-			continue;
+			//A body that is not accelerated and stays under the sleep velocity at the end of the frame goes to sleep
+			if (subStep + 1 == subStepCount)
+			{
+				isResting = (!isFalling || rigidbody.isGrounded) && rigidbody.velocity.GetSqrMagnitude() < sleepSqrVelocity &&
+					rigidbody.angularVelocity < sleepVelocity && -rigidbody.angularVelocity < sleepVelocity;
+			}
 
-		auto rigidbody = rigidbodyManager_.GetComponent(entity);
+			//Limit the players' movement
+			if (!isPlayer)
+				continue;
 
-		if (rigidbody.position.y < LOWER_LIMIT)
-		{
-			rigidbody.position.y = LOWER_LIMIT;
-			//Kill player
-		}
-		//Block positions in limits
-		if (rigidbody.position.y > UPPER_LIMIT)
-		{
-			rigidbody.position.y = UPPER_LIMIT;
+			if (rigidbody.position.y < LOWER_LIMIT)
+			{
+				rigidbody.position.y = LOWER_LIMIT;
+				//Kill player
+			}
+			//Block positions in limits
+			if (rigidbody.position.y > UPPER_LIMIT)
+			{
+				rigidbody.position.y = UPPER_LIMIT;
+			}
+			if (rigidbody.position.x > RIGHT_LIMIT)
+			{
+				rigidbody.position.x = RIGHT_LIMIT;
+			}
+			if (rigidbody.position.x < LEFT_LIMIT)
+			{
+				rigidbody.position.x = LEFT_LIMIT;
+			}
+
+			//Reduce velocity over time
+			if (rigidbody.velocity.x > 0.0f || rigidbody.velocity.x < 0.0f)
+			{
+				rigidbody.velocity.x += (0.0f - rigidbody.velocity.x) * (subStepSeconds * 2.0f);
+			}
 		}
-		if (rigidbody.position.x > RIGHT_LIMIT)
+
+		if (isResting)
 		{
-			rigidbody.position.x = RIGHT_LIMIT;
+			rigidbody.restFrameNmb++;
+			if (rigidbody.IsSleeping())
+			{
+				rigidbody.velocity = core::Vec2s::zero();
+				rigidbody.angularVelocity = zero;
+			}
 		}
-		if (rigidbody.position.x < LEFT_LIMIT)
+		else
 		{
-			rigidbody.position.x = LEFT_LIMIT;
+			rigidbody.restFrameNmb = 0;
 		}
+	}
+	dynamicBodies_.resize(dynamicBodyNmb);
+}
 
-		//Reduce velocity over time
-		if (rigidbody.velocity.x > 0.0f || rigidbody.velocity.x < 0.0f)
-		{
-			rigidbody.velocity.x += (0.0f - rigidbody.velocity.x) * (dt.asSeconds() * 2.0f);
-		}
+void PhysicsManager::SetSubStepCount(BodyClass bodyClass, std::uint32_t subStepCount)
+{
+	gpr_assert(bodyClass != BodyClass::LENGTH, "Invalid body class");
+	subStepCounts_[static_cast<std::size_t>(bodyClass)] = std::max<std::uint32_t>(subStepCount, 1);
+}
 
-		rigidbodyManager_.SetComponent(entity, rigidbody);
-	}
+void PhysicsManager::ResolveLevelContacts(Rigidbody& rigidbody, core::Scalar radius) const
+{
+	const core::Scalar zero = 0.0f;
+	const core::Scalar groundNormal = GROUND_NORMAL_Y;
+	rigidbody.isGrounded = false;
+	const core::Vec2s extent{ radius, radius };
+	//The circle is pushed out of each overlapping collider and loses its velocity going into it
+	level_->Query({ rigidbody.position - extent, rigidbody.position + extent },
+		[&rigidbody, radius, zero, groundNormal](const LevelCollider& collider)
+		{
+			core::Vec2s normal{};
+			core::Scalar depth = 0.0f;
+			if (!collider.FindContact(rigidbody.position, radius, normal, depth))
+				return;
+			rigidbody.position += normal * depth;
+			const core::Scalar normalVelocity = core::Vec2s::Dot(rigidbody.velocity, normal);
+			if (normalVelocity < zero)
+			{
+				rigidbody.velocity -= normal * normalVelocity;
+			}
+			if (normal.y >= groundNormal)
+			{
+				rigidbody.isGrounded = true;
+			}
+		});
 }
 
-void PhysicsManager::CheckForCircleCollisions()
+void PhysicsManager::CheckForCircleCollisions(sf::Time dt)
 {
+#ifdef TRACY_ENABLE
+	ZoneScoped;
+#endif
+	const core::Scalar dtSeconds = dt.asSeconds();
+	constexpr auto colliderMask = static_cast<core::EntityMask>(core::ComponentType::RIGIDBODY) |
+		static_cast<core::EntityMask>(core::ComponentType::CIRCLE_COLLIDER);
+	broadphaseBodies_.clear();
+	activeBodies_.clear();
 	for (core::Entity entity = 0; entity < entityManager_.GetEntitiesSize(); entity++)
 	{
-		//Check for sphere collisions
-		if (!entityManager_.HasComponent(entity,
-			static_cast<core::EntityMask>(core::ComponentType::RIGIDBODY) |
-			static_cast<core::EntityMask>(core::ComponentType::CIRCLE_COLLIDER)) ||
+		if (!entityManager_.HasComponent(entity, colliderMask) ||
 			entityManager_.HasComponent(entity, static_cast<core::EntityMask>(ComponentType::DESTROYED)))
 			continue;
-		
-
-		for (core::Entity otherEntity = entity + 1; otherEntity < entityManager_.GetEntitiesSize(); otherEntity++)
-		{
-			if (!entityManager_.HasComponent(otherEntity,
-				static_cast<core::EntityMask>(core::ComponentType::RIGIDBODY) | static_cast<core::EntityMask>(core::ComponentType::CIRCLE_COLLIDER)) ||
-				entityManager_.HasComponent(otherEntity, static_cast<core::EntityMask>(ComponentType::DESTROYED)))
-				continue;
-
-			if (!entityManager_.EntityExists(entity) || !entityManager_.EntityExists(otherEntity))
-				continue;
-
-			const Rigidbody& rigidbody1 = rigidbodyManager_.GetComponent(entity);
-			const CircleCollider& circle1 = circleColliderManager_.GetComponent(entity);
+		const auto& rigidbody = rigidbodyManager_.GetComponent(entity);
+		const auto& circle = circleColliderManager_.GetComponent(entity);
+		//The velocity is not changed between the integration and the collision detection, so it gives the sweep of the frame
+		broadphaseBodies_.push_back({ entity,
+			rigidbody.position,
+			circle.radius,
+			rigidbody.collisionDetection == CollisionDetection::CONTINUOUS ?
+				rigidbody.velocity * dtSeconds : core::Vec2s::zero(),
+			circle.filter });
+		activeBodies_.push_back(rigidbody.bodyType == BodyType::DYNAMIC && !rigidbody.IsSleeping());
+	}
+	switch (broadphaseType_)
+	{
+	case BroadphaseType::UNIFORM_GRID:
+		uniformGrid_.FindPairs(broadphaseBodies_, collisionPairs_);
+		break;
+	case BroadphaseType::SWEEP_AND_PRUNE:
+		sweepAndPrune_.FindPairs(broadphaseBodies_, collisionPairs_);
+		break;
+	}
 
-			const Rigidbody& rigidbody2 = rigidbodyManager_.GetComponent(otherEntity);
-			const CircleCollider& circle2 = circleColliderManager_.GetComponent(otherEntity);
+	std::erase_if(collisionPairs_, [this](const CollisionPair& pair)
+	{
+		return !activeBodies_[pair.body1] && !activeBodies_[pair.body2];
+	});
 
-			if (IsOverlappingCircle(circle1, rigidbody1, circle2, rigidbody2, mtv_))
-			{
-				onTriggerAction_.Execute(entity, otherEntity);
-			}
+	narrowphase_.FindContacts(broadphaseBodies_, collisionPairs_, contacts_);
+	//A sleeping body is woken up by a moving one, resting bodies do not wake each other up
+	for (const auto& contact : contacts_)
+	{
+		auto& rigidbody1 = rigidbodyManager_.GetComponent(contact.entity1);
+		auto& rigidbody2 = rigidbodyManager_.GetComponent(contact.entity2);
+		if (rigidbody1.IsSleeping() && rigidbody2.bodyType == BodyType::DYNAMIC && rigidbody2.restFrameNmb == 0)
+		{
+			rigidbody1.restFrameNmb = 0;
+		}
+		else if (rigidbody2.IsSleeping() && rigidbody1.bodyType == BodyType::DYNAMIC && rigidbody1.restFrameNmb == 0)
+		{
+			rigidbody2.restFrameNmb = 0;
 		}
 	}
 }
@@ -204,19 +275,59 @@ void PhysicsManager::FixedUpdate(sf::Time dt)
 	ZoneScoped;
 #endif
 
-	ApplyGravityToRigidbodies(dt);
-	LimitPlayerMovement(dt);
-	CheckForCircleCollisions();
+	IntegrateRigidbodies(dt);
+	CheckForCircleCollisions(dt);
 }
 
 void PhysicsManager::AddRigidbody(core::Entity entity)
 {
 	rigidbodyManager_.AddComponent(entity);
+	if (rigidbodyManager_.GetComponent(entity).bodyType == BodyType::DYNAMIC)
+	{
+		AddDynamicBody(entity);
+	}
 }
 
 void PhysicsManager::SetRigidbody(core::Entity entity, const Rigidbody& rigidbody)
 {
-	rigidbodyManager_.SetComponent(entity, rigidbody);
+	auto& currentRigidbody = rigidbodyManager_.GetComponent(entity);
+	const bool isMoved = rigidbody.position.x != currentRigidbody.position.x ||
+		rigidbody.position.y != currentRigidbody.position.y ||
+		rigidbody.velocity.x != currentRigidbody.velocity.x ||
+		rigidbody.velocity.y != currentRigidbody.velocity.y ||
+		rigidbody.rotation != currentRigidbody.rotation ||
+		rigidbody.angularVelocity != currentRigidbody.angularVelocity;
+	currentRigidbody = rigidbody;
+	if (isMoved)
+	{
+		currentRigidbody.restFrameNmb = 0;
+	}
+	if (rigidbody.bodyType == BodyType::DYNAMIC)
+	{
+		AddDynamicBody(entity);
+	}
+	else
+	{
+		RemoveDynamicBody(entity);
+	}
+}
+
+void PhysicsManager::AddDynamicBody(core::Entity entity)
+{
+	const auto it = std::lower_bound(dynamicBodies_.begin(), dynamicBodies_.end(), entity);
+	if (it == dynamicBodies_.end() || *it != entity)
+	{
+		dynamicBodies_.insert(it, entity);
+	}
+}
+
+void PhysicsManager::RemoveDynamicBody(core::Entity entity)
+{
+	const auto it = std::lower_bound(dynamicBodies_.begin(), dynamicBodies_.end(), entity);
+	if (it != dynamicBodies_.end() && *it == entity)
+	{
+		dynamicBodies_.erase(it);
+	}
 }
 
 const Rigidbody& PhysicsManager::GetRigidbody(core::Entity entity) const
@@ -239,20 +350,55 @@ const CircleCollider& PhysicsManager::GetCircle(core::Entity entity) const
 	return circleColliderManager_.GetComponent(entity);
 }
 
-void PhysicsManager::RegisterTriggerListener(OnTriggerInterface& onTriggerInterface)
-{
-	onTriggerAction_.RegisterCallback(
-		[&onTriggerInterface](core::Entity entity1, core::Entity entity2) { onTriggerInterface.OnTrigger(entity1, entity2); });
-}
-
 void PhysicsManager::CopyAllComponents(const PhysicsManager& physicsManager)
 {
 	rigidbodyManager_.CopyAllComponents(physicsManager.rigidbodyManager_.GetAllComponents());
 	circleColliderManager_.CopyAllComponents(physicsManager.circleColliderManager_.GetAllComponents());
+	dynamicBodies_ = physicsManager.dynamicBodies_;
+}
+
+void PhysicsManager::CopyAllComponents(std::span<const Rigidbody> rigidbodies, std::span<const CircleCollider> circles)
+{
+	rigidbodyManager_.CopyAllComponents(rigidbodies);
+	circleColliderManager_.CopyAllComponents(circles);
+	//The list of dynamic bodies is not serialized, it is rebuilt from the restored entity masks
+	dynamicBodies_.clear();
+	const auto& entityMasks = entityManager_.GetAllEntityMasks();
+	for (core::Entity entity = 0; entity < entityMasks.size() && entity < rigidbodies.size(); entity++)
+	{
+		if ((entityMasks[entity] & static_cast<core::EntityMask>(core::ComponentType::RIGIDBODY)) &&
+			rigidbodies[entity].bodyType == BodyType::DYNAMIC)
+		{
+			dynamicBodies_.push_back(entity);
+		}
+	}
+}
+
+std::size_t PhysicsManager::GetAllComponentsByteSize() const
+{
+	return rigidbodyManager_.GetAllComponents().size() * sizeof(Rigidbody) +
+		circleColliderManager_.GetAllComponents().size() * sizeof(CircleCollider) +
+		dynamicBodies_.size() * sizeof(core::Entity);
 }
 
 void PhysicsManager::Draw(sf::RenderTarget& renderTarget)
 {
+#ifdef TRACY_ENABLE
+	ZoneScoped;
+#endif
+	//Unit circle computed once, scaled and moved for each collider
+	static const auto unitCircle = []
+	{
+		std::array<sf::Vector2f, DEBUG_CIRCLE_SEGMENT_NMB> points{};
+		for (std::size_t i = 0; i < points.size(); i++)
+		{
+			const float angle = 2.0f * core::PI * static_cast<float>(i) / static_cast<float>(DEBUG_CIRCLE_SEGMENT_NMB);
+			points[i] = { std::cos(angle), std::sin(angle) };
+		}
+		return points;
+	}();
+	const sf::Color outlineColor = core::Color::green();
+	debugVertices_.clear();
 	for (core::Entity entity = 0; entity < entityManager_.GetEntitiesSize(); entity++)
 	{
 		if (!entityManager_.HasComponent(entity,
@@ -260,20 +406,31 @@ void PhysicsManager::Draw(sf::RenderTarget& renderTarget)
 			static_cast<core::EntityMask>(core::ComponentType::CIRCLE_COLLIDER)) ||
 			entityManager_.HasComponent(entity, static_cast<core::EntityMask>(ComponentType::DESTROYED)))
 			continue;
-		const auto& [radius, isTrigger] = circleColliderManager_.GetComponent(entity);
-		const auto& sphereBody = rigidbodyManager_.GetComponent(entity);
-		sf::CircleShape circleShape;
-		circleShape.setFillColor(core::Color::transparent());
-		//circleShape.setFillColor(core::Color::green());
-		circleShape.setOutlineColor(core::Color::green());
-		circleShape.setOutlineThickness(2.0f);
-		const auto spherePosition = sphereBody.position;
-		circleShape.setOrigin(radius * core::PIXEL_PER_METER, radius * core::PIXEL_PER_METER);
-		circleShape.setPosition(
+		const float radius = core::ToFloat(circleColliderManager_.GetComponent(entity).radius) * core::PIXEL_PER_METER;
+		const auto spherePosition = core::ToVec2f(rigidbodyManager_.GetComponent(entity).position);
+		const sf::Vector2f position{
 			spherePosition.x * core::PIXEL_PER_METER + center_.x,
-			windowSize_.y - (spherePosition.y * core::PIXEL_PER_METER + center_.y));
-		circleShape.setRadius(radius * core::PIXEL_PER_METER);
-		renderTarget.draw(circleShape);
+			windowSize_.y - (spherePosition.y * core::PIXEL_PER_METER + center_.y) };
+		//The outline is drawn outside of the circle, like the outline of a sf::CircleShape, with two triangles per segment
+		for (std::size_t i = 0; i < unitCircle.size(); i++)
+		{
+			const auto& point1 = unitCircle[i];
+			const auto& point2 = unitCircle[(i + 1) % unitCircle.size()];
+			const sf::Vertex inner1{ position + point1 * radius, outlineColor };
+			const sf::Vertex inner2{ position + point2 * radius, outlineColor };
+			const sf::Vertex outer1{ position + point1 * (radius + DEBUG_OUTLINE_THICKNESS), outlineColor };
+			const sf::Vertex outer2{ position + point2 * (radius + DEBUG_OUTLINE_THICKNESS), outlineColor };
+			debugVertices_.append(inner1);
+			debugVertices_.append(outer1);
+			debugVertices_.append(outer2);
+			debugVertices_.append(inner1);
+			debugVertices_.append(outer2);
+			debugVertices_.append(inner2);
+		}
+	}
+	if (debugVertices_.getVertexCount() > 0)
+	{
+		renderTarget.draw(debugVertices_);
 	}
 }
 }
@@ -21,6 +21,7 @@ void PlayerCharacterManager::FixedUpdate(sf::Time dt)
 #ifdef TRACY_ENABLE
     ZoneScoped;
 #endif
+    const core::Scalar dtSeconds = dt.asSeconds();
     for (PlayerNumber playerNumber = 0; playerNumber < MAX_PLAYER_NMB; playerNumber++)
     {
         const auto playerEntity = gameManager_.GetEntityFromPlayerNumber(playerNumber);
@@ -40,7 +41,7 @@ void PlayerCharacterManager::FixedUpdate(sf::Time dt)
         const auto movement = ((left ? -1.0f : 0.0f) + (right ? 1.0f : 0.0f)) * PLAYER_SPEED;
         if(!playerCharacter.isShooting)
         {
-            playerBody.velocity.x += movement * dt.asSeconds();
+            playerBody.velocity.x += movement * dtSeconds;
         }
 
     	//Set player jump
@@ -54,7 +55,7 @@ void PlayerCharacterManager::FixedUpdate(sf::Time dt)
         //Set player AnimationState
         if(!playerCharacter.isShooting)
         {
-            if (playerBody.position.y <= LOWER_LIMIT)
+            if (playerBody.position.y <= LOWER_LIMIT || playerBody.isGrounded)
             {
                 playerCharacter.isGrounded = true;
                 playerCharacter.animationState = AnimationState::IDLE;
@@ -79,11 +80,11 @@ void PlayerCharacterManager::FixedUpdate(sf::Time dt)
     	//Set player's looking direction
         if(right && !playerCharacter.isShooting)
         {
-            playerCharacter.lookDir = core::Vec2f::right();
+            playerCharacter.lookDir = core::Vec2s::right();
         }
         if (left && !playerCharacter.isShooting)
         {
-            playerCharacter.lookDir = core::Vec2f::left();
+            playerCharacter.lookDir = core::Vec2s::left();
         }
 
     	SetComponent(playerEntity, playerCharacter);
@@ -92,13 +93,13 @@ void PlayerCharacterManager::FixedUpdate(sf::Time dt)
 
         if (playerCharacter.invincibilityTime > 0.0f)
         {
-            playerCharacter.invincibilityTime -= dt.asSeconds();
+            playerCharacter.invincibilityTime -= dtSeconds;
             SetComponent(playerEntity, playerCharacter);
         }
         //Check if playerCharacter cannot shoot, and increase shootingTime
         if (playerCharacter.shootingTime < PLAYER_SHOOTING_PERIOD)
         {
-            playerCharacter.shootingTime += dt.asSeconds();
+            playerCharacter.shootingTime += dtSeconds;
             SetComponent(playerEntity, playerCharacter);
         }
 
@@ -120,14 +121,14 @@ void PlayerCharacterManager::FixedUpdate(sf::Time dt)
 
                     playerCharacter.currentBullet = gameManager_.SpawnBullet(playerCharacter.playerNumber,
                         bulletPosition,
-                        core::Vec2f::zero());
+                        core::Vec2s::zero());
 
                 }
                 else if (playerCharacter.bulletPower < BULLET_MAX_POWER && playerCharacter.currentBullet != NULL)
                 {
-                    if (entityManager_.EntityExists(playerCharacter.currentBullet)) 
+                    if (IsCurrentBulletAlive(playerCharacter))
                     {
-                        playerCharacter.bulletPower += dt.asSeconds() * PLAYER_CHARGE_SPEED;
+                        playerCharacter.bulletPower += dtSeconds * PLAYER_CHARGE_SPEED;
 
                         //Increasing Bullet power
                         Bullet bullet = gameManager_.GetRollbackManager().GetCurrentBulletManager().GetComponent(playerCharacter.currentBullet);
@@ -136,7 +137,7 @@ void PlayerCharacterManager::FixedUpdate(sf::Time dt)
 
                     	//Setting position of bullet to player's pos
                         Rigidbody bulletRb = physicsManager_.GetRigidbody(playerCharacter.currentBullet);
-                        const core::Vec2f bulletPosition{ playerBody.position + playerCharacter.lookDir * 0.5f};
+                        const core::Vec2s bulletPosition{ playerBody.position + playerCharacter.lookDir * 0.5f};
                         bulletRb.position = bulletPosition;
                         physicsManager_.SetRigidbody(playerCharacter.currentBullet, bulletRb);
                     }
@@ -145,7 +146,7 @@ void PlayerCharacterManager::FixedUpdate(sf::Time dt)
             }
             else if (!shoot && playerCharacter.currentBullet != NULL)
             {
-                if(entityManager_.EntityExists(playerCharacter.currentBullet))
+                if(IsCurrentBulletAlive(playerCharacter))
                 {
                     //Setting Bullet velocity on shoot release
                     const auto bullet = gameManager_.GetRollbackManager().GetCurrentBulletManager().GetComponent(playerCharacter.currentBullet);
@@ -167,4 +168,16 @@ void PlayerCharacterManager::FixedUpdate(sf::Time dt)
     	SetComponent(playerEntity, playerCharacter);
     }
 }
+
+bool PlayerCharacterManager::IsCurrentBulletAlive(const PlayerCharacter& playerCharacter) const
+{
+    const auto bullet = playerCharacter.currentBullet;
+    if (!entityManager_.EntityExists(bullet) ||
+        !entityManager_.HasComponent(bullet, static_cast<core::EntityMask>(ComponentType::BULLET)) ||
+        entityManager_.HasComponent(bullet, static_cast<core::EntityMask>(ComponentType::DESTROYED)))
+    {
+        return false;
+    }
+    return gameManager_.GetRollbackManager().GetCurrentBulletManager().GetComponent(bullet).playerNumber == playerCharacter.playerNumber;
+}
 }
@@ -0,0 +1,227 @@
+#include "game/replay.h"
+
+#include "utils/assert.h"
+#include "utils/log.h"
+
+#include <fmt/format.h>
+#include <algorithm>
+#include <functional>
+#include <limits>
+
+namespace game
+{
+
+void ReplayRecorder::Start(const core::Pcg32& random, std::uint64_t levelHash)
+{
+    isRecording_ = true;
+    random_ = random;
+    levelHash_ = levelHash;
+    spawns_.clear();
+    inputRuns_.clear();
+    validateFrames_.clear();
+    frameCount_ = 0;
+    keyframes_.clear();
+    keyframeIndex_.clear();
+}
+
+void ReplayRecorder::RecordSpawn(PlayerNumber playerNumber, core::Vec2f position, core::Vec2f direction)
+{
+    if (!isRecording_)
+        return;
+    ReplaySpawn spawn;
+    spawn.position = position;
+    spawn.direction = direction;
+    spawn.playerNumber = playerNumber;
+    const auto it = std::find_if(spawns_.begin(), spawns_.end(), [playerNumber](const auto& other)
+        {
+            return other.playerNumber == playerNumber;
+        });
+    if (it != spawns_.end())
+    {
+        *it = spawn;
+        return;
+    }
+    spawns_.push_back(spawn);
+}
+
+void ReplayRecorder::RecordFrame(Frame frame, const std::array<PlayerInput, MAX_PLAYER_NMB>& inputs)
+{
+    if (!isRecording_)
+        return;
+    gpr_assert(frame == frameCount_ + 1, fmt::format("Replay frames must be recorded in order, expected frame {} got {}", frameCount_ + 1, frame));
+    frameCount_++;
+    if (!inputRuns_.empty() &&
+        inputRuns_.back().inputs == inputs &&
+        inputRuns_.back().length < std::numeric_limits<decltype(InputRun::length)>::max())
+    {
+        inputRuns_.back().length++;
+        return;
+    }
+    InputRun inputRun;
+    inputRun.inputs = inputs;
+    inputRun.length = 1;
+    inputRuns_.push_back(inputRun);
+}
+
+void ReplayRecorder::RecordValidation(Frame validateFrame)
+{
+    if (!isRecording_ || validateFrame == 0 || (!validateFrames_.empty() && validateFrames_.back() >= validateFrame))
+        return;
+    validateFrames_.push_back(validateFrame);
+}
+
+bool ReplayRecorder::IsKeyframeNeeded(Frame validateFrame) const
+{
+    const Frame lastKeyframe = keyframeIndex_.empty() ? 0 : keyframeIndex_.back().frame;
+    return isRecording_ && validateFrame >= lastKeyframe + keyframeInterval_;
+}
+
+void ReplayRecorder::RecordKeyframe(Frame validateFrame, std::span<const std::byte> world)
+{
+    if (!isRecording_)
+        return;
+    ReplayKeyframe keyframe;
+    keyframe.frame = validateFrame;
+    keyframe.offset = keyframes_.size();
+    keyframe.size = world.size();
+    keyframes_.insert(keyframes_.end(), world.begin(), world.end());
+    keyframes_.resize(core::AlignBinarySize(keyframes_.size()));
+    keyframeIndex_.push_back(keyframe);
+}
+
+void ReplayRecorder::Write(core::BinaryWriter& writer) const
+{
+    writer.WriteValue(static_cast<std::uint32_t>(ReplayBlock::RANDOM), random_);
+    writer.WriteValue(static_cast<std::uint32_t>(ReplayBlock::LEVEL_HASH), levelHash_);
+    writer.WriteBlock(static_cast<std::uint32_t>(ReplayBlock::SPAWNS), spawns_);
+    writer.WriteBlock(static_cast<std::uint32_t>(ReplayBlock::INPUT_RUNS), inputRuns_);
+    writer.WriteBlock(static_cast<std::uint32_t>(ReplayBlock::VALIDATE_FRAMES), validateFrames_);
+    //The keyframes offsets become offsets in the file, the index is the last block so it can be written after all the keyframes
+    const auto keyframesOffset = writer.GetBuffer().size() + sizeof(core::BinaryBlockHeader);
+    writer.WriteBlock(static_cast<std::uint32_t>(ReplayBlock::KEYFRAMES), keyframes_);
+    std::vector<ReplayKeyframe> keyframeIndex = keyframeIndex_;
+    for (auto& keyframe : keyframeIndex)
+    {
+        keyframe.offset += keyframesOffset;
+    }
+    writer.WriteBlock(static_cast<std::uint32_t>(ReplayBlock::KEYFRAME_INDEX), keyframeIndex);
+}
+
+bool ReplayRecorder::WriteToFile(std::string_view path) const
+{
+    core::BinaryWriter writer(REPLAY_MAGIC, REPLAY_VERSION);
+    Write(writer);
+    if (!writer.WriteToFile(path))
+    {
+        return false;
+    }
+    core::LogDebug(fmt::format("Replay of {} frames ({} input runs, {} keyframes) written to {}",
+        frameCount_, inputRuns_.size(), keyframeIndex_.size(), path));
+    return true;
+}
+
+bool ReplayReader::Open(std::string_view path)
+{
+    isValid_ = false;
+    if (!file_.Open(path))
+    {
+        return false;
+    }
+    return Read(file_.GetData());
+}
+
+bool ReplayReader::Read(std::span<const std::byte> buffer)
+{
+    isValid_ = false;
+    const core::BinaryView view(buffer, REPLAY_MAGIC, REPLAY_VERSION);
+    if (!view.IsValid())
+    {
+        core::LogError("Invalid replay file");
+        return false;
+    }
+    const auto* random = view.GetValue<core::Pcg32>(static_cast<std::uint32_t>(ReplayBlock::RANDOM));
+    const auto* levelHash = view.GetValue<std::uint64_t>(static_cast<std::uint32_t>(ReplayBlock::LEVEL_HASH));
+    spawns_ = view.GetBlock<ReplaySpawn>(static_cast<std::uint32_t>(ReplayBlock::SPAWNS));
+    inputRuns_ = view.GetBlock<InputRun>(static_cast<std::uint32_t>(ReplayBlock::INPUT_RUNS));
+    if (random == nullptr || levelHash == nullptr || spawns_.size() != MAX_PLAYER_NMB)
+    {
+        core::LogError("Replay file is missing its random state, level hash or player spawns");
+        return false;
+    }
+    std::array<bool, MAX_PLAYER_NMB> isSpawned{};
+    for (const auto& spawn : spawns_)
+    {
+        if (spawn.playerNumber >= MAX_PLAYER_NMB || isSpawned[spawn.playerNumber])
+        {
+            core::LogError(fmt::format("Replay file has an invalid player spawn: {}", spawn.playerNumber));
+            return false;
+        }
+        isSpawned[spawn.playerNumber] = true;
+    }
+    random_ = *random;
+    levelHash_ = *levelHash;
+    frameCount_ = 0;
+    inputRunEndFrames_.clear();
+    inputRunEndFrames_.reserve(inputRuns_.size());
+    for (const auto& inputRun : inputRuns_)
+    {
+        frameCount_ += inputRun.length;
+        inputRunEndFrames_.push_back(frameCount_);
+    }
+    validateFrames_ = view.GetBlock<Frame>(static_cast<std::uint32_t>(ReplayBlock::VALIDATE_FRAMES));
+    if (std::adjacent_find(validateFrames_.begin(), validateFrames_.end(), std::greater_equal<>()) != validateFrames_.end() ||
+        (validateFrames_.empty() ? frameCount_ != 0 : validateFrames_.back() != frameCount_))
+    {
+        core::LogError("Replay file validated frames do not match its inputs");
+        return false;
+    }
+    keyframes_ = view.GetBlock<ReplayKeyframe>(static_cast<std::uint32_t>(ReplayBlock::KEYFRAME_INDEX));
+    Frame previousFrame = 0;
+    for (const auto& keyframe : keyframes_)
+    {
+        if (keyframe.frame <= previousFrame || keyframe.frame > frameCount_ ||
+            keyframe.offset % core::BINARY_ALIGNMENT != 0 ||
+            keyframe.offset > buffer.size() || keyframe.size > buffer.size() - keyframe.offset)
+        {
+            core::LogError(fmt::format("Replay file has an invalid keyframe at frame {}", keyframe.frame));
+            return false;
+        }
+        previousFrame = keyframe.frame;
+    }
+    buffer_ = buffer;
+    isValid_ = true;
+    return true;
+}
+
+std::array<PlayerInput, MAX_PLAYER_NMB> ReplayReader::GetInputs(Frame frame) const
+{
+    gpr_assert(frame >= 1 && frame <= frameCount_, fmt::format("Replay has no inputs for frame {}", frame));
+    //The first run whose last frame is at or after the frame
+    const auto it = std::lower_bound(inputRunEndFrames_.begin(), inputRunEndFrames_.end(), frame);
+    if (it == inputRunEndFrames_.end())
+    {
+        return {};
+    }
+    return inputRuns_[static_cast<std::size_t>(it - inputRunEndFrames_.begin())].inputs;
+}
+
+Frame ReplayReader::FindValidateFrame(Frame frame) const
+{
+    const auto it = std::upper_bound(validateFrames_.begin(), validateFrames_.end(), frame);
+    return it == validateFrames_.begin() ? 0 : *(it - 1);
+}
+
+const ReplayKeyframe* ReplayReader::FindKeyframe(Frame frame) const
+{
+    const auto it = std::upper_bound(keyframes_.begin(), keyframes_.end(), frame, [](Frame value, const auto& keyframe)
+        {
+            return value < keyframe.frame;
+        });
+    return it == keyframes_.begin() ? nullptr : &*(it - 1);
+}
+
+std::span<const std::byte> ReplayReader::GetKeyframeWorld(const ReplayKeyframe& keyframe) const
+{
+    return buffer_.subspan(static_cast<std::size_t>(keyframe.offset), static_cast<std::size_t>(keyframe.size));
+}
+}
@@ -0,0 +1,74 @@
+#include "game/replay_player.h"
+
+#include "utils/log.h"
+
+#include <fmt/format.h>
+#include <algorithm>
+
+#ifdef TRACY_ENABLE
+#include <Tracy.hpp>
+#endif
+
+namespace game
+{
+
+ReplayPlayer::ReplayPlayer(const ReplayReader& replay) : replay_(replay)
+{
+    Restart();
+}
+
+bool ReplayPlayer::Restart()
+{
+    gameManager_ = std::make_unique<HeadlessGameManager>();
+    isValid_ = gameManager_->StartReplay(replay_);
+    return isValid_;
+}
+
+void ReplayPlayer::PlayTo(Frame frame)
+{
+
+#ifdef TRACY_ENABLE
+    ZoneScoped;
+#endif
+    frame = replay_.FindValidateFrame(frame);
+    const auto validateFrames = replay_.GetValidateFrames();
+    auto nextValidateFrame = std::upper_bound(validateFrames.begin(), validateFrames.end(), GetFrame());
+    for (Frame currentFrame = GetFrame() + 1; currentFrame <= frame; currentFrame++)
+    {
+        gameManager_->AdvanceFrame();
+        const auto inputs = replay_.GetInputs(currentFrame);
+        for (PlayerNumber playerNumber = 0; playerNumber < MAX_PLAYER_NMB; playerNumber++)
+        {
+            gameManager_->SetPlayerInput(playerNumber, inputs[playerNumber], currentFrame);
+        }
+        if (currentFrame == *nextValidateFrame)
+        {
+            gameManager_->Validate(currentFrame);
+            ++nextValidateFrame;
+        }
+    }
+}
+
+Frame ReplayPlayer::Seek(Frame frame)
+{
+
+#ifdef TRACY_ENABLE
+    ZoneScoped;
+#endif
+    frame = replay_.FindValidateFrame(frame);
+    const auto* keyframe = replay_.FindKeyframe(frame);
+    const Frame currentFrame = GetFrame();
+    const bool isForward = frame >= currentFrame;
+    if (!isForward || (keyframe != nullptr && keyframe->frame > currentFrame))
+    {
+        Restart();
+        if (keyframe != nullptr && !gameManager_->LoadKeyframe(replay_.GetKeyframeWorld(*keyframe)))
+        {
+            core::LogWarning(fmt::format("Could not load replay keyframe {}, simulating from the start", keyframe->frame));
+        }
+    }
+    const Frame startFrame = GetFrame();
+    PlayTo(frame);
+    return frame - startFrame;
+}
+}
@@ -1,9 +1,15 @@
 #include <game/rollback_manager.h>
 #include <game/game_manager.h>
+#include <game/world_serialization.h>
 #include "utils/assert.h"
+#include "utils/hash.h"
 #include <utils/log.h>
 #include <fmt/format.h>
 
+#include <algorithm>
+#include <bit>
+#include <chrono>
+
 #ifdef TRACY_ENABLE
 #include <Tracy.hpp>
 #endif
@@ -25,7 +31,6 @@ RollbackManager::RollbackManager(GameManager& gameManager, core::EntityManager&
     {
         std::fill(input.begin(), input.end(), '\0');
     }
-    currentPhysicsManager_.RegisterTriggerListener(*this);
 }
 
 void RollbackManager::SimulateToCurrentFrame()
@@ -34,6 +39,7 @@ void RollbackManager::SimulateToCurrentFrame()
 #ifdef TRACY_ENABLE
     ZoneScoped;
 #endif
+    const auto rollbackStart = RollbackStats::Clock::now();
     const auto currentFrame = gameManager_.GetCurrentFrame();
     const auto lastValidateFrame = gameManager_.GetLastValidateFrame();
     //Destroying all created Entities after the last validated frame
@@ -58,6 +64,8 @@ void RollbackManager::SimulateToCurrentFrame()
     currentBulletManager_.CopyAllComponents(lastValidateBulletManager_.GetAllComponents());
     currentPhysicsManager_.CopyAllComponents(lastValidatePhysicsManager_);
     currentPlayerManager_.CopyAllComponents(lastValidatePlayerManager_.GetAllComponents());
+    currentRandom_ = lastValidateRandom_;
+    const auto copyBytes = GetRestoreByteSize();
 
     for (Frame frame = lastValidateFrame + 1; frame <= currentFrame; frame++)
     {
@@ -80,8 +88,13 @@ void RollbackManager::SimulateToCurrentFrame()
         currentBulletManager_.FixedUpdate(sf::seconds(FIXED_PERIOD));
         currentPlayerManager_.FixedUpdate(sf::seconds(FIXED_PERIOD));
         currentPhysicsManager_.FixedUpdate(sf::seconds(FIXED_PERIOD));
+        ManageContacts();
+        if (syncTestDepth_ != 0)
+        {
+            CheckSyncTest(frame);
+        }
     }
-    //Copy the physics states to the transforms
+    //Copy the physics states to the transforms, only the bodies that moved are marked as dirty
     for (core::Entity entity = 0; entity < entityManager_.GetEntitiesSize(); entity++)
     {
         if (!entityManager_.HasComponent(entity,
@@ -89,9 +102,12 @@ void RollbackManager::SimulateToCurrentFrame()
             static_cast<core::EntityMask>(core::ComponentType::TRANSFORM)))
             continue;
         const auto& body = currentPhysicsManager_.GetRigidbody(entity);
-        currentTransformManager_.SetPosition(entity, body.position);
-        currentTransformManager_.SetRotation(entity, body.rotation);
+        currentTransformManager_.SetPosition(entity, core::ToVec2f(body.position));
+        currentTransformManager_.SetRotation(entity, core::Degree(core::ToFloat(body.rotation)));
     }
+    rollbackStats_.RecordRollback(currentFrame > lastValidateFrame ? currentFrame - lastValidateFrame : 0,
+        copyBytes,
+        RollbackStats::Clock::now() - rollbackStart);
 }
 
 void RollbackManager::SetPlayerInput(PlayerNumber playerNumber, PlayerInput playerInput, Frame inputFrame)
@@ -101,16 +117,32 @@ void RollbackManager::SetPlayerInput(PlayerNumber playerNumber, PlayerInput play
     {
         StartNewFrame(inputFrame);
     }
-    inputs_[playerNumber][currentFrame_ - inputFrame] = playerInput;
+    auto& input = inputs_[playerNumber][currentFrame_ - inputFrame];
+    //A received input on an already simulated and not validated frame that differs from the predicted one
+    if (inputFrame < currentFrame_ && inputFrame > lastValidateFrame_ && input != playerInput)
+    {
+        rollbackStats_.RecordMisprediction(playerNumber);
+    }
+    //First frame whose input changed, the sync test hashes of the following frames are not comparable anymore
+    Frame changedFrame = input != playerInput ? inputFrame : currentFrame_ + 1;
+    input = playerInput;
     if (lastReceivedFrame_[playerNumber] < inputFrame)
     {
         lastReceivedFrame_[playerNumber] = inputFrame;
         //Repeat the same inputs until currentFrame
         for (size_t i = 0; i < currentFrame_ - inputFrame; i++)
         {
+            if (inputs_[playerNumber][i] != playerInput)
+            {
+                changedFrame = std::min(changedFrame, static_cast<Frame>(currentFrame_ - i));
+            }
             inputs_[playerNumber][i] = playerInput;
         }
     }
+    if (syncTestDepth_ != 0 && changedFrame <= currentFrame_)
+    {
+        InvalidateSyncTest(changedFrame);
+    }
 }
 
 void RollbackManager::StartNewFrame(Frame newFrame)
@@ -181,11 +213,13 @@ void RollbackManager::ValidateFrame(Frame newValidateFrame)
     currentBulletManager_.CopyAllComponents(lastValidateBulletManager_.GetAllComponents());
     currentPhysicsManager_.CopyAllComponents(lastValidatePhysicsManager_);
     currentPlayerManager_.CopyAllComponents(lastValidatePlayerManager_.GetAllComponents());
+    currentRandom_ = lastValidateRandom_;
 
     //We simulate the frames until the new validated frame
     for (Frame frame = lastValidateFrame_ + 1; frame <= newValidateFrame; frame++)
     {
         testedFrame_ = frame;
+        std::array<PlayerInput, MAX_PLAYER_NMB> frameInputs{};
         //Copy the players inputs into the player manager
         for (PlayerNumber playerNumber = 0; playerNumber < MAX_PLAYER_NMB; playerNumber++)
         {
@@ -194,11 +228,18 @@ void RollbackManager::ValidateFrame(Frame newValidateFrame)
             auto playerCharacter = currentPlayerManager_.GetComponent(playerEntity);
             playerCharacter.input = playerInput;
             currentPlayerManager_.SetComponent(playerEntity, playerCharacter);
+            frameInputs[playerNumber] = playerInput;
         }
+        gameManager_.GetReplayRecorder().RecordFrame(frame, frameInputs);
         //We simulate one frame
         currentBulletManager_.FixedUpdate(sf::seconds(FIXED_PERIOD));
         currentPlayerManager_.FixedUpdate(sf::seconds(FIXED_PERIOD));
         currentPhysicsManager_.FixedUpdate(sf::seconds(FIXED_PERIOD));
+        ManageContacts();
+        if (syncTestDepth_ != 0)
+        {
+            CheckSyncTest(frame);
+        }
     }
     //Definitely remove DESTROY entities
     for (core::Entity entity = 0; entity < entityManager_.GetEntitiesSize(); entity++)
@@ -212,8 +253,53 @@ void RollbackManager::ValidateFrame(Frame newValidateFrame)
     lastValidateBulletManager_.CopyAllComponents(currentBulletManager_.GetAllComponents());
     lastValidatePlayerManager_.CopyAllComponents(currentPlayerManager_.GetAllComponents());
     lastValidatePhysicsManager_.CopyAllComponents(currentPhysicsManager_);
+    lastValidateRandom_ = currentRandom_;
     lastValidateFrame_ = newValidateFrame;
     createdEntities_.clear();
+
+    auto& replayRecorder = gameManager_.GetReplayRecorder();
+    replayRecorder.RecordValidation(lastValidateFrame_);
+    if (replayRecorder.IsKeyframeNeeded(lastValidateFrame_))
+    {
+        replayRecorder.RecordKeyframe(lastValidateFrame_, gameManager_.SaveWorld());
+    }
+}
+
+void RollbackManager::RewindToValidateFrame()
+{
+    for (const auto& createdEntity : createdEntities_)
+    {
+        if (createdEntity.createdFrame > lastValidateFrame_)
+        {
+            entityManager_.DestroyEntity(createdEntity.entity);
+        }
+    }
+    createdEntities_.clear();
+    for (core::Entity entity = 0; entity < entityManager_.GetEntitiesSize(); entity++)
+    {
+        if (entityManager_.HasComponent(entity, static_cast<core::EntityMask>(ComponentType::DESTROYED)))
+        {
+            entityManager_.RemoveComponent(entity, static_cast<core::EntityMask>(ComponentType::DESTROYED));
+        }
+    }
+    currentBulletManager_.CopyAllComponents(lastValidateBulletManager_.GetAllComponents());
+    currentPhysicsManager_.CopyAllComponents(lastValidatePhysicsManager_);
+    currentPlayerManager_.CopyAllComponents(lastValidatePlayerManager_.GetAllComponents());
+    currentRandom_ = lastValidateRandom_;
+
+    //Shift the inputs window so that it starts at the last validated frame
+    const auto delta = currentFrame_ - lastValidateFrame_;
+    for (auto& inputs : inputs_)
+    {
+        for (std::size_t i = 0; i < inputs.size(); i++)
+        {
+            inputs[i] = i + delta < inputs.size() ? inputs[i + delta] : PlayerInput{};
+        }
+    }
+    lastReceivedFrame_.fill(lastValidateFrame_);
+    currentFrame_ = lastValidateFrame_;
+    testedFrame_ = lastValidateFrame_;
+    InvalidateSyncTest(lastValidateFrame_ + 1);
 }
 
 void RollbackManager::ConfirmFrame(Frame newValidatedFrame, const std::array<PhysicsState, MAX_PLAYER_NMB>& serverPhysicsState)
@@ -238,41 +324,38 @@ void RollbackManager::ConfirmFrame(Frame newValidatedFrame, const std::array<Phy
     }
 }
 
+namespace
+{
+/**
+ * \brief AddPhysicsState adds the bits of a value to a physics state checksum, PhysicsState word by PhysicsState word.
+ */
+template<typename T>
+void AddPhysicsState(PhysicsState& state, const T& value)
+{
+    static_assert(sizeof(T) % sizeof(PhysicsState) == 0);
+    //bit_cast instead of a reinterpret_cast of the pointer, which breaks strict aliasing and is optimized away
+    const auto words = std::bit_cast<std::array<PhysicsState, sizeof(T) / sizeof(PhysicsState)>>(value);
+    for (const auto word : words)
+    {
+        state += word;
+    }
+}
+}
+
 PhysicsState RollbackManager::GetValidatePhysicsState(PlayerNumber playerNumber) const
 {
     PhysicsState state = 0;
     const core::Entity playerEntity = gameManager_.GetEntityFromPlayerNumber(playerNumber);
     const auto& playerBody = lastValidatePhysicsManager_.GetRigidbody(playerEntity);
 
-    const auto pos = playerBody.position;
-    const auto* posPtr = reinterpret_cast<const PhysicsState*>(&pos);
     //Adding position
-    for (size_t i = 0; i < sizeof(core::Vec2f) / sizeof(PhysicsState); i++)
-    {
-        state += posPtr[i];
-    }
-
+    AddPhysicsState(state, playerBody.position);
     //Adding velocity
-    const auto velocity = playerBody.velocity;
-    const auto* velocityPtr = reinterpret_cast<const PhysicsState*>(&velocity);
-    for (size_t i = 0; i < sizeof(core::Vec2f) / sizeof(PhysicsState); i++)
-    {
-        state += velocityPtr[i];
-    }
+    AddPhysicsState(state, playerBody.velocity);
     //Adding rotation
-    const auto angle = playerBody.rotation.value();
-    const auto* anglePtr = reinterpret_cast<const PhysicsState*>(&angle);
-    for (size_t i = 0; i < sizeof(float) / sizeof(PhysicsState); i++)
-    {
-        state += anglePtr[i];
-    }
+    AddPhysicsState(state, playerBody.rotation);
     //Adding angular Velocity
-    const auto angularVelocity = playerBody.angularVelocity.value();
-    const auto* angularVelPtr = reinterpret_cast<const PhysicsState*>(&angularVelocity);
-    for (size_t i = 0; i < sizeof(float) / sizeof(PhysicsState); i++)
-    {
-        state += angularVelPtr[i];
-    }
+    AddPhysicsState(state, playerBody.angularVelocity);
     return state;
 }
 
@@ -283,14 +366,16 @@ void RollbackManager::SpawnPlayer(PlayerNumber playerNumber, core::Entity entity
     ZoneScoped;
 #endif
     Rigidbody playerBody;
-    playerBody.position = position;
+    playerBody.position = core::Vec2s(position);
 
     CircleCollider playerCircle;
     playerCircle.radius = 0.5f;
+    playerCircle.filter.category = PLAYER_COLLISION_CATEGORY;
+    playerCircle.filter.owner = playerNumber;
 
     PlayerCharacter playerCharacter;
     playerCharacter.playerNumber = playerNumber;
-    playerCharacter.lookDir = lookDirection;
+    playerCharacter.lookDir = core::Vec2s(lookDirection);
     playerCharacter.animationState = AnimationState::NONE;
 
     currentPlayerManager_.AddComponent(entity);
@@ -315,135 +400,446 @@ void RollbackManager::SpawnPlayer(PlayerNumber playerNumber, core::Entity entity
     currentTransformManager_.SetScale(entity, core::Vec2f{ PLAYER_SCALE.x  * lookDirection.x,PLAYER_SCALE.y});
 }
 
-PlayerInput RollbackManager::GetInputAtFrame(PlayerNumber playerNumber, Frame frame) const
+std::size_t RollbackManager::GetRestoreByteSize() const
 {
-    gpr_assert(currentFrame_ - frame < inputs_[playerNumber].size(),
-        "Trying to get input too far in the past");
-    return inputs_[playerNumber][currentFrame_ - frame];
+    return lastValidateBulletManager_.GetAllComponents().size() * sizeof(Bullet) +
+        lastValidatePlayerManager_.GetAllComponents().size() * sizeof(PlayerCharacter) +
+        lastValidatePhysicsManager_.GetAllComponentsByteSize() +
+        sizeof(lastValidateRandom_);
 }
 
-void RollbackManager::OnTrigger(core::Entity entity1, core::Entity entity2)
+void RollbackManager::SetRandomSeed(std::uint64_t seed)
 {
-    const std::function<void(core::Entity, core::Entity)> ManagePlayerCollision =
-        [this](auto entity1, auto entity2)
-    {
-        auto player1Rigidbody = currentPhysicsManager_.GetRigidbody(entity1);
-        auto player2Rigidbody = currentPhysicsManager_.GetRigidbody(entity2);
-        auto mtv = currentPhysicsManager_.GetMTV();
+    currentRandom_.Seed(seed);
+    lastValidateRandom_ = currentRandom_;
+}
 
-        PhysicsManager::SolveCollision(player1Rigidbody, player2Rigidbody);
-        PhysicsManager::SolveMTV(player1Rigidbody, player2Rigidbody, mtv);
+void RollbackManager::SetRandom(const core::Pcg32& random)
+{
+    currentRandom_ = random;
+    lastValidateRandom_ = random;
+}
+
+std::uint64_t RollbackManager::GetValidateWorldHash() const
+{
+
+#ifdef TRACY_ENABLE
+    ZoneScoped;
+#endif
+    return GetWorldHash(lastValidatePhysicsManager_, lastValidatePlayerManager_, lastValidateBulletManager_,
+        lastValidateRandom_, lastValidateFrame_, 0, createdEntities_);
+}
 
-        currentPhysicsManager_.SetRigidbody(entity1, player1Rigidbody);
-        currentPhysicsManager_.SetRigidbody(entity2, player2Rigidbody);
-    };
+std::uint64_t RollbackManager::GetCurrentWorldHash() const
+{
 
-	const std::function<void(const PlayerCharacter&, core::Entity, const Bullet&, core::Entity)> ManagePlayerBulletCollision =
-        [this](const auto& player, auto playerEntity, const auto& bullet, auto bulletEntity)
+#ifdef TRACY_ENABLE
+    ZoneScoped;
+#endif
+    //Entities destroyed in the current state are not simulated anymore, and are freed when their frame is validated
+    return GetWorldHash(currentPhysicsManager_, currentPlayerManager_, currentBulletManager_,
+        currentRandom_, testedFrame_, static_cast<core::EntityMask>(ComponentType::DESTROYED), {});
+}
+
+std::uint64_t RollbackManager::GetWorldHash(const PhysicsManager& physicsManager,
+    const PlayerCharacterManager& playerManager,
+    const BulletManager& bulletManager,
+    const core::Pcg32& random,
+    Frame frame,
+    core::EntityMask excludedMask,
+    std::span<const CreatedEntity> skippedEntities) const
+{
+    //Entities are hashed separately and summed, as the index of an entity depends on when destroyed entities were freed
+    std::uint64_t entitiesHash = 0;
+    constexpr auto simulatedMask =
+        static_cast<core::EntityMask>(core::ComponentType::RIGIDBODY) |
+        static_cast<core::EntityMask>(core::ComponentType::CIRCLE_COLLIDER) |
+        static_cast<core::EntityMask>(ComponentType::PLAYER_CHARACTER) |
+        static_cast<core::EntityMask>(ComponentType::BULLET);
+    const auto& entityMasks = entityManager_.GetAllEntityMasks();
+    for (core::Entity entity = 0; entity < entityMasks.size(); entity++)
     {
-        if (player.playerNumber != bullet.playerNumber)
-        {
-            auto playerRigidbody = currentPhysicsManager_.GetRigidbody(playerEntity);
-            auto bulletRigidbody = currentPhysicsManager_.GetRigidbody(bulletEntity);
-            gameManager_.DestroyBullet(bulletEntity);
-            //lower health point
-            auto playerCharacter = currentPlayerManager_.GetComponent(playerEntity);
-            if (playerCharacter.invincibilityTime <= 0.0f)
+        const auto entityMask = entityMasks[entity] & simulatedMask;
+        if (entityMask == 0 || (entityMasks[entity] & excludedMask) != 0 || std::any_of(skippedEntities.begin(), skippedEntities.end(), [entity](const auto& createdEntity)
             {
-                core::LogDebug(fmt::format("Player {} is hit by bullet", playerCharacter.playerNumber));
-                playerCharacter.health -= bullet.power * (PLAYER_HEALTH/BULLET_PER_LIFE_COEF);
-                playerCharacter.invincibilityTime = PLAYER_INVINCIBILITY_PERIOD;
-                if(bulletRigidbody.velocity.x > 0)
-                {
-                    playerRigidbody.velocity.x = (1 / bulletRigidbody.velocity.x) * BULLET_PUSH_POWER;
-                }
-            	else
-                {
-                    playerRigidbody.velocity.x = (playerRigidbody.position - bulletRigidbody.position).GetNormalized().x * bullet.power * 10.0f;
-                }
-                
-            }
-            currentPlayerManager_.SetComponent(playerEntity, playerCharacter);
-            currentPhysicsManager_.SetRigidbody(playerEntity, playerRigidbody);
+                return createdEntity.entity == entity;
+            }))
+        {
+            continue;
+        }
+        core::Fnv1aHash hash;
+        hash.Add(entityMask);
+        if (entityMask & static_cast<core::EntityMask>(core::ComponentType::RIGIDBODY))
+        {
+            const auto& body = physicsManager.GetRigidbody(entity);
+            hash.Add(body.position.x);
+            hash.Add(body.position.y);
+            hash.Add(body.rotation);
+            hash.Add(body.velocity.x);
+            hash.Add(body.velocity.y);
+            hash.Add(body.angularVelocity);
+            hash.Add(body.acceleration.x);
+            hash.Add(body.acceleration.y);
+            hash.Add(body.bodyType);
+            hash.Add(body.collisionDetection);
+            hash.Add(body.restFrameNmb);
+            hash.Add(body.bounciness);
+            hash.Add(body.gravityScale);
+            hash.Add(body.isGrounded);
         }
-    };
+        if (entityMask & static_cast<core::EntityMask>(core::ComponentType::CIRCLE_COLLIDER))
+        {
+            const auto& circle = physicsManager.GetCircle(entity);
+            hash.Add(circle.radius);
+            hash.Add(circle.isTrigger);
+            hash.Add(circle.filter.category);
+            hash.Add(circle.filter.mask);
+            hash.Add(circle.filter.owner);
+        }
+        if (entityMask & static_cast<core::EntityMask>(ComponentType::PLAYER_CHARACTER))
+        {
+            const auto& player = playerManager.GetComponent(entity);
+            hash.Add(player.input);
+            hash.Add(player.playerNumber);
+            hash.Add(player.health);
+            hash.Add(player.shootingTime);
+            hash.Add(player.invincibilityTime);
+            hash.Add(player.isGrounded);
+            hash.Add(player.isShooting);
+            hash.Add(player.lookDir.x);
+            hash.Add(player.lookDir.y);
+            hash.Add(player.animationState);
+            hash.Add(player.bulletPower);
+        }
+        if (entityMask & static_cast<core::EntityMask>(ComponentType::BULLET))
+        {
+            const auto& bullet = bulletManager.GetComponent(entity);
+            hash.Add(bullet.playerNumber);
+            hash.Add(bullet.remainingTime);
+            hash.Add(bullet.power);
+        }
+        entitiesHash += hash.GetValue();
+    }
+    core::Fnv1aHash hash;
+    //The level is not part of the rollback state, but worlds simulated with different levels must not match
+    const auto* level = physicsManager.GetLevel();
+    hash.Add(level != nullptr ? level->GetHash() : std::uint64_t{ 0 });
+    hash.Add(frame);
+    hash.Add(random.state);
+    hash.Add(random.increment);
+    hash.Add(entitiesHash);
+    return hash.GetValue();
+}
+
+void RollbackManager::SetSyncTestDepth(Frame syncTestDepth)
+{
+    syncTestDepth_ = syncTestDepth;
+    syncTestHashes_.fill({});
+    syncTestChecks_ = 0;
+    syncTestErrors_ = 0;
+}
 
-    const std::function<void(core::Entity, Bullet, core::Entity, Bullet)> ManageBulletCollision =
-        [this](auto entity1, auto bullet1, auto entity2, auto bullet2)
+void RollbackManager::SetLevel(const Level* level)
+{
+    currentPhysicsManager_.SetLevel(level);
+    lastValidatePhysicsManager_.SetLevel(level);
+}
+
+void RollbackManager::SetPhysicsSubStepCount(BodyClass bodyClass, std::uint32_t subStepCount)
+{
+    currentPhysicsManager_.SetSubStepCount(bodyClass, subStepCount);
+    lastValidatePhysicsManager_.SetSubStepCount(bodyClass, subStepCount);
+}
+
+void RollbackManager::CheckSyncTest(Frame frame)
+{
+    auto& syncTestHash = syncTestHashes_[frame % syncTestHashes_.size()];
+    const auto hash = GetCurrentWorldHash();
+    if (syncTestHash.frame != frame)
     {
-        auto bullet1Rigidbody = currentPhysicsManager_.GetRigidbody(entity1);
-        auto bullet2Rigidbody = currentPhysicsManager_.GetRigidbody(entity2);
+        syncTestHash = { frame, hash };
+        return;
+    }
+    syncTestChecks_++;
+    if (syncTestHash.hash != hash)
+    {
+        syncTestErrors_++;
+        core::LogError(fmt::format("Sync test failed at frame {} (last validated frame: {}, current frame: {}): first simulation {:016x}, resimulation {:016x}",
+            frame, lastValidateFrame_, currentFrame_, syncTestHash.hash, hash));
+        //The new simulation becomes the reference, so that a divergence is reported once and not for all the following frames
+        syncTestHash.hash = hash;
+        InvalidateSyncTest(frame + 1);
+    }
+}
 
-        auto bullet1Transform = currentTransformManager_.GetScale(entity1);
-        auto bullet2Transform = currentTransformManager_.GetScale(entity2);
+void RollbackManager::InvalidateSyncTest(Frame fromFrame)
+{
+    for (auto& syncTestHash : syncTestHashes_)
+    {
+        if (syncTestHash.frame >= fromFrame)
+        {
+            syncTestHash = {};
+        }
+    }
+}
 
-        auto mtv = currentPhysicsManager_.GetMTV();
-        if (bullet1.playerNumber == bullet2.playerNumber)
+namespace
+{
+/**
+ * \brief HasAllComponents checks that a components array read from a serialized world covers all the entities that have its component.
+ * Entities created after the last validated frame are skipped for the validated components arrays.
+ */
+template<typename T>
+bool HasAllComponents(const core::EntityManager& entityManager, std::span<const T> components, core::EntityMask mask,
+    std::span<const CreatedEntity> createdEntities = {})
+{
+    const auto& entityMasks = entityManager.GetAllEntityMasks();
+    for (core::Entity entity = 0; entity < entityMasks.size(); entity++)
+    {
+        if ((entityMasks[entity] & mask) != mask || entity < components.size())
         {
-            return;
+            continue;
         }
-        if(bullet1.power > bullet2.power)
+        if (std::none_of(createdEntities.begin(), createdEntities.end(), [entity](const auto& createdEntity)
+            {
+                return createdEntity.entity == entity;
+            }))
         {
-            bullet1.power -= bullet2.power;
-            currentBulletManager_.SetComponent(entity1, bullet1);
-            bullet2Transform = core::Vec2f::zero();
-            currentTransformManager_.SetScale(entity2, bullet2Transform);
-            gameManager_.DestroyBullet(entity2);
+            return false;
         }
-        else if(bullet2.power > bullet1.power)
+    }
+    return true;
+}
+}
+
+void RollbackManager::WriteState(core::BinaryWriter& writer) const
+{
+    const std::array<Frame, 3> frames{ currentFrame_, lastValidateFrame_, testedFrame_ };
+    writer.WriteValue(static_cast<std::uint32_t>(WorldBlock::ROLLBACK_FRAMES), frames);
+    writer.WriteValue(static_cast<std::uint32_t>(WorldBlock::LAST_RECEIVED_FRAMES), lastReceivedFrame_);
+    writer.WriteValue(static_cast<std::uint32_t>(WorldBlock::INPUTS), inputs_);
+    writer.WriteBlock(static_cast<std::uint32_t>(WorldBlock::CREATED_ENTITIES), createdEntities_);
+
+    writer.WriteBlock(static_cast<std::uint32_t>(WorldBlock::ROLLBACK_TRANSFORM_POSITIONS), currentTransformManager_.GetAllPositions());
+    writer.WriteBlock(static_cast<std::uint32_t>(WorldBlock::ROLLBACK_TRANSFORM_SCALES), currentTransformManager_.GetAllScales());
+    writer.WriteBlock(static_cast<std::uint32_t>(WorldBlock::ROLLBACK_TRANSFORM_ROTATIONS), currentTransformManager_.GetAllRotations());
+
+    writer.WriteBlock(static_cast<std::uint32_t>(WorldBlock::CURRENT_RIGIDBODIES), currentPhysicsManager_.GetAllRigidbodies());
+    writer.WriteBlock(static_cast<std::uint32_t>(WorldBlock::CURRENT_CIRCLES), currentPhysicsManager_.GetAllCircles());
+    writer.WriteBlock(static_cast<std::uint32_t>(WorldBlock::CURRENT_PLAYERS), currentPlayerManager_.GetAllComponents());
+    writer.WriteBlock(static_cast<std::uint32_t>(WorldBlock::CURRENT_BULLETS), currentBulletManager_.GetAllComponents());
+    writer.WriteValue(static_cast<std::uint32_t>(WorldBlock::CURRENT_RANDOM), currentRandom_);
+
+    writer.WriteBlock(static_cast<std::uint32_t>(WorldBlock::VALIDATE_RIGIDBODIES), lastValidatePhysicsManager_.GetAllRigidbodies());
+    writer.WriteBlock(static_cast<std::uint32_t>(WorldBlock::VALIDATE_CIRCLES), lastValidatePhysicsManager_.GetAllCircles());
+    writer.WriteBlock(static_cast<std::uint32_t>(WorldBlock::VALIDATE_PLAYERS), lastValidatePlayerManager_.GetAllComponents());
+    writer.WriteBlock(static_cast<std::uint32_t>(WorldBlock::VALIDATE_BULLETS), lastValidateBulletManager_.GetAllComponents());
+    writer.WriteValue(static_cast<std::uint32_t>(WorldBlock::VALIDATE_RANDOM), lastValidateRandom_);
+}
+
+bool RollbackManager::ReadState(const core::BinaryView& view)
+{
+    const auto* frames = view.GetValue<std::array<Frame, 3>>(static_cast<std::uint32_t>(WorldBlock::ROLLBACK_FRAMES));
+    const auto* lastReceivedFrames = view.GetValue<decltype(lastReceivedFrame_)>(static_cast<std::uint32_t>(WorldBlock::LAST_RECEIVED_FRAMES));
+    const auto* inputs = view.GetValue<decltype(inputs_)>(static_cast<std::uint32_t>(WorldBlock::INPUTS));
+    const auto* currentRandom = view.GetValue<core::Pcg32>(static_cast<std::uint32_t>(WorldBlock::CURRENT_RANDOM));
+    const auto* validateRandom = view.GetValue<core::Pcg32>(static_cast<std::uint32_t>(WorldBlock::VALIDATE_RANDOM));
+    const auto createdEntities = view.GetBlock<CreatedEntity>(static_cast<std::uint32_t>(WorldBlock::CREATED_ENTITIES));
+
+    const auto positions = view.GetBlock<core::Vec2f>(static_cast<std::uint32_t>(WorldBlock::ROLLBACK_TRANSFORM_POSITIONS));
+    const auto scales = view.GetBlock<core::Vec2f>(static_cast<std::uint32_t>(WorldBlock::ROLLBACK_TRANSFORM_SCALES));
+    const auto rotations = view.GetBlock<core::Degree>(static_cast<std::uint32_t>(WorldBlock::ROLLBACK_TRANSFORM_ROTATIONS));
+
+    const auto currentRigidbodies = view.GetBlock<Rigidbody>(static_cast<std::uint32_t>(WorldBlock::CURRENT_RIGIDBODIES));
+    const auto currentCircles = view.GetBlock<CircleCollider>(static_cast<std::uint32_t>(WorldBlock::CURRENT_CIRCLES));
+    const auto currentPlayers = view.GetBlock<PlayerCharacter>(static_cast<std::uint32_t>(WorldBlock::CURRENT_PLAYERS));
+    const auto currentBullets = view.GetBlock<Bullet>(static_cast<std::uint32_t>(WorldBlock::CURRENT_BULLETS));
+    const auto validateRigidbodies = view.GetBlock<Rigidbody>(static_cast<std::uint32_t>(WorldBlock::VALIDATE_RIGIDBODIES));
+    const auto validateCircles = view.GetBlock<CircleCollider>(static_cast<std::uint32_t>(WorldBlock::VALIDATE_CIRCLES));
+    const auto validatePlayers = view.GetBlock<PlayerCharacter>(static_cast<std::uint32_t>(WorldBlock::VALIDATE_PLAYERS));
+    const auto validateBullets = view.GetBlock<Bullet>(static_cast<std::uint32_t>(WorldBlock::VALIDATE_BULLETS));
+
+    if (frames == nullptr || lastReceivedFrames == nullptr || inputs == nullptr ||
+        currentRandom == nullptr || validateRandom == nullptr)
+    {
+        core::LogError("Serialized world is missing rollback blocks");
+        return false;
+    }
+    constexpr auto rigidbodyMask = static_cast<core::EntityMask>(core::ComponentType::RIGIDBODY);
+    constexpr auto circleMask = static_cast<core::EntityMask>(core::ComponentType::CIRCLE_COLLIDER);
+    constexpr auto playerMask = static_cast<core::EntityMask>(ComponentType::PLAYER_CHARACTER);
+    constexpr auto bulletMask = static_cast<core::EntityMask>(ComponentType::BULLET);
+    if (!HasAllComponents(entityManager_, positions, static_cast<core::EntityMask>(core::ComponentType::POSITION)) ||
+        !HasAllComponents(entityManager_, scales, static_cast<core::EntityMask>(core::ComponentType::SCALE)) ||
+        !HasAllComponents(entityManager_, rotations, static_cast<core::EntityMask>(core::ComponentType::ROTATION)) ||
+        !HasAllComponents(entityManager_, currentRigidbodies, rigidbodyMask) ||
+        !HasAllComponents(entityManager_, validateRigidbodies, rigidbodyMask, createdEntities) ||
+        !HasAllComponents(entityManager_, currentCircles, circleMask) ||
+        !HasAllComponents(entityManager_, validateCircles, circleMask, createdEntities) ||
+        !HasAllComponents(entityManager_, currentPlayers, playerMask) ||
+        !HasAllComponents(entityManager_, validatePlayers, playerMask, createdEntities) ||
+        !HasAllComponents(entityManager_, currentBullets, bulletMask) ||
+        !HasAllComponents(entityManager_, validateBullets, bulletMask, createdEntities))
+    {
+        core::LogError("Serialized world components do not match its entities");
+        return false;
+    }
+
+    currentFrame_ = (*frames)[0];
+    lastValidateFrame_ = (*frames)[1];
+    testedFrame_ = (*frames)[2];
+    lastReceivedFrame_ = *lastReceivedFrames;
+    inputs_ = *inputs;
+    createdEntities_.assign(createdEntities.begin(), createdEntities.end());
+
+    currentTransformManager_.CopyAllComponents(positions, scales, rotations);
+    currentPhysicsManager_.CopyAllComponents(currentRigidbodies, currentCircles);
+    currentPlayerManager_.CopyAllComponents(currentPlayers);
+    currentBulletManager_.CopyAllComponents(currentBullets);
+    currentRandom_ = *currentRandom;
+
+    lastValidatePhysicsManager_.CopyAllComponents(validateRigidbodies, validateCircles);
+    lastValidatePlayerManager_.CopyAllComponents(validatePlayers);
+    lastValidateBulletManager_.CopyAllComponents(validateBullets);
+    lastValidateRandom_ = *validateRandom;
+    return true;
+}
+
+PlayerInput RollbackManager::GetInputAtFrame(PlayerNumber playerNumber, Frame frame) const
+{
+    gpr_assert(currentFrame_ - frame < inputs_[playerNumber].size(),
+        "Trying to get input too far in the past");
+    return inputs_[playerNumber][currentFrame_ - frame];
+}
+
+const RollbackManager::ContactHandlerTable RollbackManager::CONTACT_HANDLERS = []
+{
+    constexpr auto player = static_cast<std::size_t>(ContactCategory::PLAYER);
+    constexpr auto bullet = static_cast<std::size_t>(ContactCategory::BULLET);
+    //The pairs of categories without rules stay nullptr
+    ContactHandlerTable contactHandlers{};
+    contactHandlers[player][player] = &RollbackManager::ManagePlayerCollision;
+    contactHandlers[player][bullet] = &RollbackManager::ManagePlayerBulletCollision;
+    contactHandlers[bullet][player] = &RollbackManager::ManageBulletPlayerCollision;
+    contactHandlers[bullet][bullet] = &RollbackManager::ManageBulletCollision;
+    return contactHandlers;
+}();
+
+void RollbackManager::ManageContacts()
+{
+#ifdef TRACY_ENABLE
+    ZoneScoped;
+#endif
+    constexpr auto colliderMask = static_cast<core::EntityMask>(core::ComponentType::RIGIDBODY) |
+        static_cast<core::EntityMask>(core::ComponentType::CIRCLE_COLLIDER);
+    constexpr auto destroyedMask = static_cast<core::EntityMask>(ComponentType::DESTROYED);
+    //Previous contacts can destroy the entities of the following ones, so the masks are read for each contact
+    const auto& entityMasks = entityManager_.GetAllEntityMasks();
+    for (const auto& contact : currentPhysicsManager_.GetContacts())
+    {
+        const auto entityMask1 = entityMasks[contact.entity1];
+        const auto entityMask2 = entityMasks[contact.entity2];
+        if (entityMask1 == core::INVALID_ENTITY_MASK || entityMask2 == core::INVALID_ENTITY_MASK ||
+            (entityMask1 & colliderMask) != colliderMask || (entityMask2 & colliderMask) != colliderMask ||
+            (entityMask1 & destroyedMask) != 0 || (entityMask2 & destroyedMask) != 0)
+            continue;
+        const auto contactHandler = CONTACT_HANDLERS
+            [static_cast<std::size_t>(GetContactCategory(entityMask1))]
+            [static_cast<std::size_t>(GetContactCategory(entityMask2))];
+        if (contactHandler != nullptr)
+        {
+            (this->*contactHandler)(contact.entity1, contact.entity2, contact);
+        }
+    }
+}
+
+void RollbackManager::ManagePlayerCollision(core::Entity player1Entity, core::Entity player2Entity, const Contact& contact)
+{
+    auto player1Rigidbody = currentPhysicsManager_.GetRigidbody(player1Entity);
+    auto player2Rigidbody = currentPhysicsManager_.GetRigidbody(player2Entity);
+
+    PhysicsManager::SolveCollision(player1Rigidbody, player2Rigidbody);
+    PhysicsManager::SolveMTV(player1Rigidbody, player2Rigidbody, contact.mtv);
+
+    currentPhysicsManager_.SetRigidbody(player1Entity, player1Rigidbody);
+    currentPhysicsManager_.SetRigidbody(player2Entity, player2Rigidbody);
+}
+
+void RollbackManager::ManagePlayerBulletCollision(core::Entity playerEntity, core::Entity bulletEntity, [[maybe_unused]] const Contact& contact)
+{
+    const auto bullet = currentBulletManager_.GetComponent(bulletEntity);
+    auto playerCharacter = currentPlayerManager_.GetComponent(playerEntity);
+    if (playerCharacter.playerNumber == bullet.playerNumber)
+    {
+        return;
+    }
+    auto playerRigidbody = currentPhysicsManager_.GetRigidbody(playerEntity);
+    const auto bulletRigidbody = currentPhysicsManager_.GetRigidbody(bulletEntity);
+    gameManager_.DestroyBullet(bulletEntity);
+    //lower health point
+    if (playerCharacter.invincibilityTime <= 0.0f)
+    {
+        core::LogDebug(fmt::format("Player {} is hit by bullet", playerCharacter.playerNumber));
+        playerCharacter.health -= bullet.power * (PLAYER_HEALTH/BULLET_PER_LIFE_COEF);
+        playerCharacter.invincibilityTime = PLAYER_INVINCIBILITY_PERIOD;
+        if(bulletRigidbody.velocity.x > 0)
         {
-            bullet2.power -= bullet1.power;
-            currentBulletManager_.SetComponent(entity2, bullet2);
-            bullet1Transform = core::Vec2f::zero();
-            currentTransformManager_.SetScale(entity1, bullet1Transform);
-            gameManager_.DestroyBullet(entity1);
+            playerRigidbody.velocity.x = (1 / bulletRigidbody.velocity.x) * BULLET_PUSH_POWER;
         }
         else
         {
-            PhysicsManager::SolveCollision(bullet1Rigidbody, bullet2Rigidbody);
-            PhysicsManager::SolveMTV(bullet1Rigidbody, bullet2Rigidbody, mtv);
-            gameManager_.DestroyBullet(entity1);
-            gameManager_.DestroyBullet(entity2);
+            playerRigidbody.velocity.x = (playerRigidbody.position - bulletRigidbody.position).GetNormalized().x * bullet.power * 10.0f;
         }
+    }
+    currentPlayerManager_.SetComponent(playerEntity, playerCharacter);
+    currentPhysicsManager_.SetRigidbody(playerEntity, playerRigidbody);
+}
 
-		if(entityManager_.HasComponent(entity1, static_cast<core::EntityMask>(core::ComponentType::RIGIDBODY)))
-        currentPhysicsManager_.SetRigidbody(entity1, bullet1Rigidbody);
-        if (entityManager_.HasComponent(entity2, static_cast<core::EntityMask>(core::ComponentType::RIGIDBODY)))
-        currentPhysicsManager_.SetRigidbody(entity2, bullet2Rigidbody);
-    };
+void RollbackManager::ManageBulletPlayerCollision(core::Entity bulletEntity, core::Entity playerEntity, const Contact& contact)
+{
+    ManagePlayerBulletCollision(playerEntity, bulletEntity, contact);
+}
 
-    //Collision between players
-	if (entityManager_.HasComponent(entity1, static_cast<core::EntityMask>(ComponentType::PLAYER_CHARACTER)) &&
-        entityManager_.HasComponent(entity2, static_cast<core::EntityMask>(ComponentType::PLAYER_CHARACTER)))
+void RollbackManager::ManageBulletCollision(core::Entity bullet1Entity, core::Entity bullet2Entity, const Contact& contact)
+{
+    auto bullet1 = currentBulletManager_.GetComponent(bullet1Entity);
+    auto bullet2 = currentBulletManager_.GetComponent(bullet2Entity);
+    if (bullet1.playerNumber == bullet2.playerNumber)
     {
-        ManagePlayerCollision(entity1, entity2);
+        return;
     }
-    //Collision with player and bullet
-    if (entityManager_.HasComponent(entity1, static_cast<core::EntityMask>(ComponentType::PLAYER_CHARACTER)) &&
-        entityManager_.HasComponent(entity2, static_cast<core::EntityMask>(ComponentType::BULLET)))
+    auto bullet1Rigidbody = currentPhysicsManager_.GetRigidbody(bullet1Entity);
+    auto bullet2Rigidbody = currentPhysicsManager_.GetRigidbody(bullet2Entity);
+
+    if(bullet1.power > bullet2.power)
     {
-        const auto& player = currentPlayerManager_.GetComponent(entity1);
-        const auto& bullet = currentBulletManager_.GetComponent(entity2);
-        ManagePlayerBulletCollision(player, entity1, bullet, entity2);
+        bullet1.power -= bullet2.power;
+        currentBulletManager_.SetComponent(bullet1Entity, bullet1);
+        currentTransformManager_.SetScale(bullet2Entity, core::Vec2f::zero());
+        gameManager_.DestroyBullet(bullet2Entity);
     }
-    if (entityManager_.HasComponent(entity2, static_cast<core::EntityMask>(ComponentType::PLAYER_CHARACTER)) &&
-        entityManager_.HasComponent(entity1, static_cast<core::EntityMask>(ComponentType::BULLET)))
+    else if(bullet2.power > bullet1.power)
     {
-        const auto& player = currentPlayerManager_.GetComponent(entity2);
-        const auto& bullet = currentBulletManager_.GetComponent(entity1);
-        ManagePlayerBulletCollision(player, entity2, bullet, entity1);
+        bullet2.power -= bullet1.power;
+        currentBulletManager_.SetComponent(bullet2Entity, bullet2);
+        currentTransformManager_.SetScale(bullet1Entity, core::Vec2f::zero());
+        gameManager_.DestroyBullet(bullet1Entity);
     }
-    //Bullet collision
-    if (entityManager_.HasComponent(entity2, static_cast<core::EntityMask>(ComponentType::BULLET)) &&
-        entityManager_.HasComponent(entity1, static_cast<core::EntityMask>(ComponentType::BULLET)))
+    else
     {
-        const auto& bullet1 = currentBulletManager_.GetComponent(entity1);
-        const auto& bullet2 = currentBulletManager_.GetComponent(entity2);
-        ManageBulletCollision(entity1, bullet1, entity2, bullet2);
+        PhysicsManager::SolveCollision(bullet1Rigidbody, bullet2Rigidbody);
+        PhysicsManager::SolveMTV(bullet1Rigidbody, bullet2Rigidbody, contact.mtv);
+        gameManager_.DestroyBullet(bullet1Entity);
+        gameManager_.DestroyBullet(bullet2Entity);
     }
+
+    if(entityManager_.HasComponent(bullet1Entity, static_cast<core::EntityMask>(core::ComponentType::RIGIDBODY)))
+        currentPhysicsManager_.SetRigidbody(bullet1Entity, bullet1Rigidbody);
+    if (entityManager_.HasComponent(bullet2Entity, static_cast<core::EntityMask>(core::ComponentType::RIGIDBODY)))
+        currentPhysicsManager_.SetRigidbody(bullet2Entity, bullet2Rigidbody);
 }
 
-void RollbackManager::SpawnBullet(PlayerNumber playerNumber, core::Entity entity, core::Vec2f position, core::Vec2f velocity)
+void RollbackManager::SpawnBullet(PlayerNumber playerNumber, core::Entity entity, core::Vec2s position, core::Vec2s velocity)
 {
     createdEntities_.push_back({ entity, testedFrame_ });
 
@@ -451,8 +847,12 @@ void RollbackManager::SpawnBullet(PlayerNumber playerNumber, core::Entity entity
     bulletBody.position = position;
     bulletBody.velocity = velocity;
     bulletBody.gravityScale = 0.0f;
+    bulletBody.collisionDetection = CollisionDetection::CONTINUOUS;
     CircleCollider bulletSphere;
     bulletSphere.radius = 0.25f;
+    //The bullets of a player never touch the player nor each other
+    bulletSphere.filter.category = BULLET_COLLISION_CATEGORY;
+    bulletSphere.filter.owner = playerNumber;
 
     currentBulletManager_.AddComponent(entity);
     currentBulletManager_.SetComponent(entity, {  playerNumber, BULLET_PERIOD, 0.0f });
@@ -462,6 +862,41 @@ void RollbackManager::SpawnBullet(PlayerNumber playerNumber, core::Entity entity
     currentPhysicsManager_.AddCircle(entity);
     currentPhysicsManager_.SetCircle(entity, bulletSphere);
 
+    currentTransformManager_.AddComponent(entity);
+    currentTransformManager_.SetPosition(entity, core::ToVec2f(position));
+    currentTransformManager_.SetScale(entity, core::Vec2f::one());
+    currentTransformManager_.SetRotation(entity, core::Degree(0.0f));
+}
+
+void RollbackManager::SpawnValidatedBullet(PlayerNumber playerNumber, core::Entity entity, core::Vec2f position, core::Vec2f velocity)
+{
+    Rigidbody bulletBody;
+    bulletBody.position = core::Vec2s(position);
+    bulletBody.velocity = core::Vec2s(velocity);
+    bulletBody.gravityScale = 0.0f;
+    bulletBody.collisionDetection = CollisionDetection::CONTINUOUS;
+    CircleCollider bulletSphere;
+    bulletSphere.radius = 0.25f;
+    bulletSphere.filter.category = BULLET_COLLISION_CATEGORY;
+    bulletSphere.filter.owner = playerNumber;
+    const Bullet bullet{ playerNumber, BULLET_PERIOD, 0.0f };
+
+    currentBulletManager_.AddComponent(entity);
+    currentBulletManager_.SetComponent(entity, bullet);
+
+    currentPhysicsManager_.AddRigidbody(entity);
+    currentPhysicsManager_.SetRigidbody(entity, bulletBody);
+    currentPhysicsManager_.AddCircle(entity);
+    currentPhysicsManager_.SetCircle(entity, bulletSphere);
+
+    lastValidateBulletManager_.AddComponent(entity);
+    lastValidateBulletManager_.SetComponent(entity, bullet);
+
+    lastValidatePhysicsManager_.AddRigidbody(entity);
+    lastValidatePhysicsManager_.SetRigidbody(entity, bulletBody);
+    lastValidatePhysicsManager_.AddCircle(entity);
+    lastValidatePhysicsManager_.SetCircle(entity, bulletSphere);
+
     currentTransformManager_.AddComponent(entity);
     currentTransformManager_.SetPosition(entity, position);
     currentTransformManager_.SetScale(entity, core::Vec2f::one());
@@ -0,0 +1,94 @@
+#include "game/rollback_stats.h"
+
+#include <imgui.h>
+
+#include <algorithm>
+#include <numeric>
+
+#ifdef TRACY_ENABLE
+#include <Tracy.hpp>
+#endif
+
+namespace game
+{
+
+void RollbackStats::RecordRollback(Frame depth, std::size_t copyBytes, Duration duration)
+{
+    lastDepth_ = depth;
+    maxDepth_ = std::max(maxDepth_, depth);
+    lastCopyBytes_ = copyBytes;
+    lastTimePerFrame_ = depth > 0 ? duration.count() / static_cast<float>(depth) : 0.0f;
+    rollbackCount_++;
+    resimulatedFrames_ += depth;
+
+    depthHistory_[historyIndex_] = static_cast<float>(depth);
+    timePerFrameHistory_[historyIndex_] = lastTimePerFrame_;
+    copyBytesHistory_[historyIndex_] = static_cast<float>(copyBytes);
+    historyIndex_ = (historyIndex_ + 1) % HISTORY_SIZE;
+    depthHistogram_[std::min<std::size_t>(depth / DEPTH_BUCKET_SIZE, DEPTH_BUCKET_NMB - 1)] += 1.0f;
+
+    //Resimulated frames per second are computed over a one second window
+    windowResimulatedFrames_ += depth;
+    const auto now = Clock::now();
+    const std::chrono::duration<float> windowDuration = now - windowStart_;
+    if (windowDuration.count() >= 1.0f)
+    {
+        resimulatedFramesPerSecond_ = static_cast<float>(windowResimulatedFrames_) / windowDuration.count();
+        windowResimulatedFrames_ = 0;
+        windowStart_ = now;
+    }
+    PlotTracy();
+}
+
+void RollbackStats::RecordMisprediction(PlayerNumber playerNumber)
+{
+    mispredictions_[playerNumber]++;
+#ifdef TRACY_ENABLE
+    TracyPlot("Rollback mispredictions", static_cast<std::int64_t>(
+        std::accumulate(mispredictions_.begin(), mispredictions_.end(), std::uint64_t{ 0 })));
+#endif
+}
+
+void RollbackStats::Reset()
+{
+    *this = RollbackStats();
+}
+
+void RollbackStats::DrawImGui()
+{
+    if (!ImGui::CollapsingHeader("Rollback Stats"))
+        return;
+    ImGui::Text("Rollbacks: %llu, resimulated frames: %llu",
+        static_cast<unsigned long long>(rollbackCount_),
+        static_cast<unsigned long long>(resimulatedFrames_));
+    ImGui::Text("Depth: %u (max: %u)", lastDepth_, maxDepth_);
+    ImGui::Text("Resimulated frames per second: %.1f", resimulatedFramesPerSecond_);
+    ImGui::Text("Time per resimulated frame: %.4f ms", lastTimePerFrame_);
+    ImGui::Text("Copy bytes per restore: %zu", lastCopyBytes_);
+    for (PlayerNumber playerNumber = 0; playerNumber < MAX_PLAYER_NMB; playerNumber++)
+    {
+        ImGui::Text("Mispredictions P%u: %llu", playerNumber + 1,
+            static_cast<unsigned long long>(mispredictions_[playerNumber]));
+    }
+    const auto offset = static_cast<int>(historyIndex_);
+    ImGui::PlotLines("Depth", depthHistory_.data(), static_cast<int>(HISTORY_SIZE), offset,
+        nullptr, 0.0f, static_cast<float>(WINDOW_BUFFER_SIZE));
+    ImGui::PlotLines("Time per frame (ms)", timePerFrameHistory_.data(), static_cast<int>(HISTORY_SIZE), offset);
+    ImGui::PlotLines("Copy bytes", copyBytesHistory_.data(), static_cast<int>(HISTORY_SIZE), offset);
+    ImGui::PlotHistogram("Depth histogram", depthHistogram_.data(), static_cast<int>(DEPTH_BUCKET_NMB));
+    if (ImGui::Button("Reset Rollback Stats"))
+    {
+        Reset();
+    }
+}
+
+void RollbackStats::PlotTracy() const
+{
+#ifdef TRACY_ENABLE
+    TracyPlot("Rollback depth", static_cast<std::int64_t>(lastDepth_));
+    TracyPlot("Rollback time per frame (ms)", lastTimePerFrame_);
+    TracyPlot("Rollback copy bytes", static_cast<std::int64_t>(lastCopyBytes_));
+    TracyPlot("Resimulated frames per second", resimulatedFramesPerSecond_);
+#endif
+}
+}
@@ -170,19 +170,23 @@ void NetworkServer::Update([[maybe_unused]] sf::Time dt)
         default: break;
         }
     }
+    //Receive all the pending UDP packets before validating once for this tick
     sf::Packet udpPacket;
     sf::IpAddress address;
     unsigned short port;
-    const auto status = udpSocket_.receive(udpPacket, address, port);
-    if (status == sf::Socket::Done)
+    while (udpSocket_.receive(udpPacket, address, port) == sf::Socket::Done)
     {
         ReceiveNetPacket(udpPacket, PacketSocketSource::UDP, address, port);
     }
+    ValidateReceivedFrames();
 }
 
 void NetworkServer::End()
 {
-
+    if (gameManager_.IsRecording())
+    {
+        gameManager_.StopRecording();
+    }
 }
 
 void NetworkServer::SetTcpPort(unsigned short i)
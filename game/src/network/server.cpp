@@ -3,6 +3,8 @@
 #include <fmt/format.h>
 #include <utils/conversion.h>
 #include <cstdint>
+#include <algorithm>
+#include <thread>
 
 #ifdef TRACY_ENABLE
 #include <Tracy.hpp>
@@ -10,6 +12,15 @@
 
 namespace game
 {
+Server::Server()
+{
+    gameManager_.GetRollbackManager().SetPhysicsThreadCount(std::thread::hardware_concurrency());
+}
+
+void Server::SetValidationInterval(Frame validationInterval)
+{
+    validationInterval_ = std::max(validationInterval, Frame{ 1 });
+}
 
 void Server::ReceivePacket(std::unique_ptr<Packet> packet)
 {
@@ -67,46 +78,7 @@ void Server::ReceivePacket(std::unique_ptr<Packet> packet)
 
         SendUnreliablePacket(std::move(packet));
 
-        //Validate new frame if needed
-        std::uint32_t lastReceiveFrame = gameManager_.GetRollbackManager().GetLastReceivedFrame(0);
-        for (PlayerNumber i = 1; i < MAX_PLAYER_NMB; i++)
-        {
-            const auto playerLastFrame = gameManager_.GetRollbackManager().GetLastReceivedFrame(i);
-            if (playerLastFrame < lastReceiveFrame)
-            {
-                lastReceiveFrame = playerLastFrame;
-            }
-        }
-        if (lastReceiveFrame > gameManager_.GetLastValidateFrame())
-        {
-            //Validate frame
-            gameManager_.Validate(lastReceiveFrame);
-
-            auto validatePacket = std::make_unique<ValidateFramePacket>();
-            validatePacket->newValidateFrame = core::ConvertToBinary(lastReceiveFrame);
-
-            //copy physics state
-            for (PlayerNumber i = 0; i < MAX_PLAYER_NMB; i++)
-            {
-                auto physicsState = gameManager_.GetRollbackManager().GetValidatePhysicsState(i);
-                const auto* statePtr = reinterpret_cast<const std::uint8_t*>(&physicsState);
-                for (size_t j = 0; j < sizeof(PhysicsState); j++)
-                {
-                    validatePacket->physicsState[i * sizeof(PhysicsState) + j] = statePtr[j];
-                }
-            }
-            SendUnreliablePacket(std::move(validatePacket));
-            const auto winner = gameManager_.CheckWinner();
-            if (winner != INVALID_PLAYER)
-            {
-                core::LogDebug(fmt::format("Server declares P{} a winner", static_cast<unsigned>(winner) + 1));
-                auto winGamePacket = std::make_unique<WinGamePacket>();
-                winGamePacket->winner = winner;
-                SendReliablePacket(std::move(winGamePacket));
-                gameManager_.WinGame(winner);
-            }
-        }
-
+        //Validation is done once per server tick in ValidateReceivedFrames
         break;
     }
     case PacketType::PING:
@@ -119,4 +91,51 @@ void Server::ReceivePacket(std::unique_ptr<Packet> packet)
     default: break;
     }
 }
+
+void Server::ValidateReceivedFrames()
+{
+
+#ifdef TRACY_ENABLE
+    ZoneScoped;
+#endif
+    std::uint32_t lastReceiveFrame = gameManager_.GetRollbackManager().GetLastReceivedFrame(0);
+    for (PlayerNumber i = 1; i < MAX_PLAYER_NMB; i++)
+    {
+        const auto playerLastFrame = gameManager_.GetRollbackManager().GetLastReceivedFrame(i);
+        if (playerLastFrame < lastReceiveFrame)
+        {
+            lastReceiveFrame = playerLastFrame;
+        }
+    }
+    if (lastReceiveFrame < gameManager_.GetLastValidateFrame() + validationInterval_)
+    {
+        return;
+    }
+    //Validate frame
+    gameManager_.Validate(lastReceiveFrame);
+
+    auto validatePacket = std::make_unique<ValidateFramePacket>();
+    validatePacket->newValidateFrame = core::ConvertToBinary(lastReceiveFrame);
+
+    //copy physics state
+    for (PlayerNumber i = 0; i < MAX_PLAYER_NMB; i++)
+    {
+        auto physicsState = gameManager_.GetRollbackManager().GetValidatePhysicsState(i);
+        const auto* statePtr = reinterpret_cast<const std::uint8_t*>(&physicsState);
+        for (size_t j = 0; j < sizeof(PhysicsState); j++)
+        {
+            validatePacket->physicsState[i * sizeof(PhysicsState) + j] = statePtr[j];
+        }
+    }
+    SendUnreliablePacket(std::move(validatePacket));
+    const auto winner = gameManager_.CheckWinner();
+    if (winner != INVALID_PLAYER)
+    {
+        core::LogDebug(fmt::format("Server declares P{} a winner", static_cast<unsigned>(winner) + 1));
+        auto winGamePacket = std::make_unique<WinGamePacket>();
+        winGamePacket->winner = winner;
+        SendReliablePacket(std::move(winGamePacket));
+        gameManager_.WinGame(winner);
+    }
+}
 }
@@ -42,6 +42,7 @@ void SimulationServer::Update(sf::Time dt)
         }
 
     }
+    ValidateReceivedFrames();
 
     packetIt = sentPackets_.begin();
     while (packetIt != sentPackets_.end())
@@ -81,6 +82,11 @@ void SimulationServer::DrawImGui()
         marginDelay_ = (maxDelay - minDelay) / 2.0f;
     }
     ImGui::SliderFloat("Packet Loss", &packetLoss_, 0.0f, 1.0f);
+    int validationInterval = static_cast<int>(validationInterval_);
+    if (ImGui::SliderInt("Validation Interval", &validationInterval, 1, static_cast<int>(MAX_INPUT_NMB)))
+    {
+        SetValidationInterval(static_cast<Frame>(validationInterval));
+    }
     ImGui::End();
 }
 
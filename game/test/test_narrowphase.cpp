@@ -0,0 +1,141 @@
+#include "game/game_manager.h"
+#include "game/narrowphase.h"
+#include "maths/random.h"
+#include "utils/hash.h"
+#include <gtest/gtest.h>
+
+#include <array>
+#include <memory>
+#include <vector>
+
+namespace
+{
+constexpr std::array<std::size_t, 4> THREAD_COUNTS{ 1, 2, 4, 8 };
+
+/**
+ * \brief HashContacts hashes the contacts member by member, so that two lists are equal only if they have the same bits.
+ */
+std::uint64_t HashContacts(const std::vector<game::Contact>& contacts)
+{
+    core::Fnv1aHash hash;
+    hash.Add(contacts.size());
+    for (const auto& contact : contacts)
+    {
+        hash.Add(contact.entity1);
+        hash.Add(contact.entity2);
+        hash.Add(contact.normal.x);
+        hash.Add(contact.normal.y);
+        hash.Add(contact.mtv.x);
+        hash.Add(contact.mtv.y);
+    }
+    return hash.GetValue();
+}
+
+/**
+ * \brief SpawnCrowd spawns all the players and a crowd of bullets of alternating owners around the middle of the arena,
+ * so that the frames have enough pairs to be split between all the threads.
+ */
+void SpawnCrowd(game::HeadlessGameManager& gameManager)
+{
+    for (game::PlayerNumber playerNumber = 0; playerNumber < game::MAX_PLAYER_NMB; playerNumber++)
+    {
+        gameManager.SpawnPlayer(playerNumber,
+            game::SPAWN_POSITIONS[playerNumber],
+            game::SPAWN_DIRECTION[playerNumber]);
+    }
+    core::Pcg32 random(game::RANDOM_SEED);
+    for (int i = 0; i < 1024; i++)
+    {
+        const core::Vec2f position{ random.RandomRange(-3.0f, 3.0f), random.RandomRange(-1.0f, 3.0f) };
+        const core::Vec2f velocity{ random.RandomRange(-game::BULLET_SPEED, game::BULLET_SPEED), random.RandomRange(-0.5f, 0.5f) };
+        gameManager.SpawnValidatedBullet(static_cast<game::PlayerNumber>(i % 2), position, velocity);
+    }
+}
+}
+
+TEST(Narrowphase, ParallelMatchesSingleThreaded)
+{
+    //A dense cluster of moving circles, each pair is a candidate, so both the overlap and the swept tests are used
+    core::Pcg32 random(game::RANDOM_SEED);
+    std::vector<game::BroadphaseBody> bodies(256);
+    for (std::size_t i = 0; i < bodies.size(); i++)
+    {
+        auto& body = bodies[i];
+        body.entity = static_cast<core::Entity>(i);
+        body.position = core::Vec2s(core::Vec2f(random.RandomRange(-4.0f, 4.0f), random.RandomRange(-4.0f, 4.0f)));
+        body.radius = random.RandomRange(0.1f, 0.5f);
+        if (i % 3 == 0)
+        {
+            body.displacement = core::Vec2s(core::Vec2f(random.RandomRange(-2.0f, 2.0f), random.RandomRange(-2.0f, 2.0f)));
+        }
+    }
+    std::vector<game::CollisionPair> pairs;
+    for (std::uint32_t body1 = 0; body1 < bodies.size(); body1++)
+    {
+        for (std::uint32_t body2 = body1 + 1; body2 < bodies.size(); body2++)
+        {
+            pairs.push_back({ bodies[body1].entity, bodies[body2].entity, body1, body2 });
+        }
+    }
+    ASSERT_GT(pairs.size(), game::ParallelNarrowphase::MIN_TASK_PAIR_NMB * THREAD_COUNTS.back());
+
+    std::vector<game::Contact> expected;
+    game::CircleNarrowphase::FindContacts(bodies, pairs, expected);
+    ASSERT_FALSE(expected.empty());
+    for (const auto threadCount : THREAD_COUNTS)
+    {
+        game::ParallelNarrowphase narrowphase;
+        narrowphase.SetThreadCount(threadCount);
+        EXPECT_EQ(threadCount, narrowphase.GetThreadCount());
+        std::vector<game::Contact> contacts;
+        //Twice, to reuse the workers of the first frame
+        for (int frame = 0; frame < 2; frame++)
+        {
+            narrowphase.FindContacts(bodies, pairs, contacts);
+            EXPECT_EQ(HashContacts(expected), HashContacts(contacts)) << threadCount << " threads, frame " << frame;
+        }
+    }
+}
+
+TEST(Narrowphase, ThreadCountKeepsWorldHash)
+{
+    constexpr game::Frame frameNmb = 60;
+    std::vector<std::unique_ptr<game::HeadlessGameManager>> gameManagers;
+    for (const auto threadCount : THREAD_COUNTS)
+    {
+        auto& gameManager = gameManagers.emplace_back(std::make_unique<game::HeadlessGameManager>());
+        gameManager->GetRollbackManager().SetPhysicsThreadCount(threadCount);
+        SpawnCrowd(*gameManager);
+    }
+    bool isParallel = false;
+    for (game::Frame frame = 1; frame <= frameNmb; frame++)
+    {
+        for (auto& gameManager : gameManagers)
+        {
+            gameManager->AdvanceFrame();
+            for (game::PlayerNumber playerNumber = 0; playerNumber < game::MAX_PLAYER_NMB; playerNumber++)
+            {
+                const game::PlayerInput input = (frame / 10u + playerNumber) % 2u ?
+                    game::PlayerInputEnum::RIGHT : game::PlayerInputEnum::SHOOT;
+                gameManager->SetPlayerInput(playerNumber, input, frame);
+            }
+            gameManager->Validate(frame);
+        }
+        auto& reference = gameManagers.front()->GetRollbackManager();
+        const auto referencePairNmb = reference.GetCurrentPhysicsManager().GetCollisionPairs().size();
+        isParallel |= referencePairNmb >= game::ParallelNarrowphase::MIN_TASK_PAIR_NMB * 2;
+        const auto referenceContacts = reference.GetCurrentPhysicsManager().GetContacts();
+        const auto referenceContactHash = HashContacts({ referenceContacts.begin(), referenceContacts.end() });
+        for (std::size_t i = 1; i < gameManagers.size(); i++)
+        {
+            auto& rollbackManager = gameManagers[i]->GetRollbackManager();
+            const auto contacts = rollbackManager.GetCurrentPhysicsManager().GetContacts();
+            EXPECT_EQ(referenceContactHash, HashContacts({ contacts.begin(), contacts.end() }))
+                << THREAD_COUNTS[i] << " threads, frame " << frame;
+            ASSERT_EQ(reference.GetValidateWorldHash(), rollbackManager.GetValidateWorldHash())
+                << THREAD_COUNTS[i] << " threads, frame " << frame;
+        }
+    }
+    //Otherwise the scene is too sparse to test the workers
+    EXPECT_TRUE(isParallel);
+}